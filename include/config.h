@@ -5,6 +5,7 @@
 #include <Adafruit_NeoPixel.h>
 #include <Encoder.h>
 #include "eepromStorage.h"
+#include "hardware.h"
 
 typedef unsigned char byte;
 
@@ -15,31 +16,23 @@ const char* const PROJECT_VERSION = "0.2";
 const char* const PROJECT_NAME = "EvoCmdWing";
 
 // ================================
-// PIN DEFINITIONS
+// HARDWARE LAYOUT
 // ================================
-const int LED_PIN = 10;              // NeoPixel data pin
-const int LATCH_LED_PIN = 13;        // GPIO pin for latching inner outter flip button
+// Pins, encoder roles, note/CC numbers and the pixel map come from the layout selected in hardware.h
+const int LED_PIN = Hardware::LED_PIN;              // NeoPixel data pin
+const int LATCH_LED_PIN = Hardware::LATCH_LED_PIN;  // GPIO pin for latching inner outter flip button
 
 // ================================
 // ENCODER/BUTTON CONFIGURATION
 // ================================
-const int N_ENCODERS = 13;
-const int N_BUTTONS = 14;
-
-// GPIO pins for encoder a/b
-extern const int ENC_PINS[N_ENCODERS][2];
-
-// GPIO pin for encoder click, and inner outter button
-extern const int BUTTON_PIN[N_BUTTONS];
+const int N_ENCODERS = Hardware::NUM_ENCODERS;
+const int N_BUTTONS = Hardware::NUM_ENCODERS + 1;   // Encoder clicks, then the inner outter flip button
+const int FLIP_BUTTON_INDEX = N_BUTTONS - 1;
 
 // ================================
 // MIDI CONFIGURATION
 // ================================
-// first 5 are for attribute encoders, next 8 are for XKeys encoders
-extern const byte ENCODER_NOTES[N_ENCODERS];
-
-// first 5 for encoders, next 8 for XKeys, last one for inner outter flip
-extern const byte BUTTON_NOTES[N_BUTTONS];
+// Encoder CCs and button notes are in the layout (hw.encoders[i].cc / hw.buttonNotes[i])
 
 // Here you can play with the velocity scaling to get the sensitivity you like
 // This works well for me with no accel in Pro Plugins Midi Encoders plugin
@@ -50,56 +43,106 @@ extern const int VELOCITY_SCALES[8][8];
 //midi channel to send on
 extern byte midiCh;
 
+// Channels below are the wing's own (1-4), config.midiChannelBase moves them to a block of the 16 MIDI
+// channels so several wings can share one port (the plugin's channelBase, CONFIG SET midiChannelBase)
+// In the native build channel 16 is input injection, so a base of 12 loses its link channel there
+inline byte wingToMidiChannel(byte wingChannel) {
+  return (byte)(wingChannel + config.midiChannelBase);
+}
+// 1-4 for the wing's channels, anything else belongs to another wing
+inline int midiToWingChannel(byte midiChannel) {
+  return (int)midiChannel - config.midiChannelBase;
+}
+
 // ================================
 // LED CONFIGURATION
 // ================================
-const int NUM_LOGO_PIXELS = 6;       // Number of pixels in logo section
-const int NUM_XKEYS = 16;            // Number of X-keys
-const int LEDS_PER_XKEY = 2;         // LEDs per X-key
-const int NUM_OFF_LEDS = 18;         // Number of pixels that need to be skiped (both strips need to skip the first and 1 between each key and 2 between the larger gap)
-const int TOTAL_PIXELS = (NUM_LOGO_PIXELS + (NUM_XKEYS * LEDS_PER_XKEY) + NUM_OFF_LEDS); // Logo + XKey LEDs + spacer pixels
-
-// LED mapping structure for X-key to pixel index conversion
-// Each X-key has a start index for its first LED
-// Layout: [6 logo pixels][skip][2 xkey1 LEDs][skip][2 xkey2 LEDs][skip][2 xkey3 LEDs][skip][2 xkey4 LEDs][skip * 2]....
-struct XKeyLEDMapping {
-  int firstPixelIndex;              // Index of first LED for this X-key
-  int secondPixelIndex;             // Index of second LED for this X-key
-};
+const int NUM_LOGO_PIXELS = Hardware::NUM_LOGO_PIXELS;  // Number of pixels in logo section
+const int NUM_XKEYS = Hardware::NUM_XKEYS;              // Number of X-keys
+const int XKEY_COLUMNS = Hardware::XKEY_COLUMNS;        // X-keys per row
+const int XKEY_ROWS = NUM_XKEYS / XKEY_COLUMNS;
+const int TOTAL_PIXELS = Hardware::TOTAL_PIXELS;        // Logo + XKey LEDs + spacer pixels
 
-// Default LED mapping - can be manually adjusted if physical layout differs
-extern XKeyLEDMapping xkeyLEDMap[NUM_XKEYS];
+// Per XKey pixel pairs are in the layout (hw.xkeys[i])
 
 // Note: Brightness controls are now in the config struct (eeprom.h)
 
 // ================================
-// LED UPDATE DEBOUNCE SYSTEM
+// LED FRAME SCHEDULER
+// ================================
+// Tracks which XKeys have changes waiting to be shown and shows the strip as soon as every
+// touched key is consistent (status applied and RGB triplet complete), instead of waiting for
+// a pause in MIDI traffic. Partial triplets are shown anyway once they reach the max frame age.
+const unsigned long LED_FRAME_MIN_INTERVAL_MS = 10; // Frame rate cap (100fps), a 58 pixel show takes ~1.8ms
+const unsigned long LED_FRAME_MAX_AGE_MS = 50;      // Show a frame no later than this after its first change
+
+// ================================
+// LED EFFECTS
 // ================================
-// This prevents LED flashing when multiple MIDI messages arrive in quick succession
-extern unsigned long lastMidiUpdateTime;
-const unsigned long MIDI_DEBOUNCE_MS = 50; // Wait 50ms after last MIDI message before updating LEDs
-extern bool hasPendingLEDUpdate;
+// Per XKey effects animated by the firmware, so the plugin sends one command instead of streaming colors.
+// Set on MIDI channel 3 for the current or write page and stored with the page's executor status:
+//   CC 32 + n (XKey n+1) = effect * 16 + rate, rate 0-15 picks LED_EFFECT_PERIODS_MS (slow to fast)
+//   CC 3 = phase (0-127 = 0-1 period) for the next effect command only
+// Blink and pulse run on one clock, keys with the same rate and phase stay in step. Flash and fade
+// run once for one period when their key changes. Effects are not part of the page digests.
+enum LEDEffect : uint8_t {
+  LED_EFFECT_NONE = 0,
+  LED_EFFECT_BLINK = 1,   // Status color and black, half a period each
+  LED_EFFECT_PULSE = 2,   // Breathes between LED_EFFECT_PULSE_FLOOR and the status color
+  LED_EFFECT_FLASH = 3,   // Flash on go: white at onBrightness fading to the on color when the key turns on
+  LED_EFFECT_FADE = 4,    // Crossfade from the previous color on status or RGB changes
+  LED_EFFECT_COUNT
+};
+const byte EFFECT_CC_PHASE = 3;
+const byte EFFECT_CC_FIRST = 32;
+static_assert(EFFECT_CC_FIRST + NUM_XKEYS <= 128, "Effect CCs must fit in CC 0-127");
+const unsigned long LED_EFFECT_FRAME_MS = 20;   // Effect animation rate (50fps), every effect frame is a strip show
+const uint16_t LED_EFFECT_PERIODS_MS[16] = {4000, 3000, 2000, 1500, 1200, 1000, 800, 600,
+                                            500, 400, 300, 250, 200, 150, 100, 60};
+const uint8_t LED_EFFECT_PULSE_FLOOR = 24;      // Pulse minimum level, out of 256
+
+// ================================
+// FADER LEVEL DISPLAY
+// ================================
+// Turning an XKey encoder shows its value on the LEDs right away, computed here without waiting for
+// grandMA3, then blends back to the executor colors. Mode in config.faderLevelDisplay (CONFIG SET).
+enum FaderLevelDisplay {
+  FADER_LEVEL_OFF = 0,
+  FADER_LEVEL_KEY = 1,    // The encoder's XKey at the level's brightness, in its executor color
+  FADER_LEVEL_BAR = 2     // A bar across the XKey's row, the last key lit partly
+};
+const unsigned long FADER_LEVEL_HOLD_MS = 1200; // Level shown this long after the last detent
+const unsigned long FADER_LEVEL_FADE_MS = 400;  // Then blended back to the executor colors over this
 
 
 // ================================
 // PAGE-BASED EXECUTOR STATUS DATA STRUCTURE
 // ================================
 // Structure to hold executor status information from grandMA3
-// Receives data on MIDI channel 2 using optimized CC mapping:
+// Receives data on MIDI channel 2 using optimized CC mapping (V0.2, 16 XKeys):
 // - Status: XKeys 1-16 use CC 1-16 (combined populated/on state)
 // - RGB: XKeys 1-16 use CC 17-64 (3 CCs each, only when populated)
+// Both ranges follow NUM_XKEYS: status CC 1-N, RGB CC N+1 to 4N
 // Page changes received on MIDI channel 3, CC 1 (page number 1-127)
+// Channel 3, CC 2 selects the page the following channel 1/2 data is stored for (1-127, 0 = current page),
+// the plugin uses it to prefetch pages in the background. A page change (CC 1) ends it.
+const byte PAGE_CC_CURRENT = 1;
+const byte PAGE_CC_WRITE = 2;
 struct ExecutorStatus {
   bool isOn;           // On/off state of executor
   bool isPopulated;    // Whether executor has sequence assigned
   uint8_t red;         // Red  (0-127 MIDI range)
   uint8_t green;       // Green (0-127 MIDI range)
   uint8_t blue;        // Blue (0-127 MIDI range)
+  bool hasFaderValue;  // faderValue is set (XKeys with an absolute encoder, once turned or synced on this page)
+  uint8_t faderValue;  // Absolute encoder value (0-127), swapped into encoderValues on page change
+  uint8_t effect;      // LED effect * 16 + rate, 0 = none (see LED EFFECTS)
+  uint8_t effectPhase; // LED effect phase (0-127)
 };
 
-// Page-based storage for up to 127 pages, 16 XKeys each
+// Page-based storage for up to 127 pages, NUM_XKEYS each
 // pageData[page][xkey] where page = 0-126 (for pages 1-127), xkey = 0-15 (for XKeys 1-16)
-extern ExecutorStatus pageData[127][16];
+extern ExecutorStatus pageData[127][NUM_XKEYS];
 
 // Current page tracking (1-127, but stored as 0-126 index)
 extern int currentPage;
@@ -110,7 +153,7 @@ extern ExecutorStatus* xkeyStatus;
 // ================================
 // ENCODER MANAGEMENT
 // ================================
-// Array to store current values for encoders 5-12 (absolute mode)
+// Array to store current values for the absolute (XKey) encoders
 extern int encoderValues[N_ENCODERS];
 
 extern Encoder* encoders[N_ENCODERS];
@@ -123,7 +166,14 @@ extern unsigned long lastDebounceTime[N_BUTTONS];
 extern unsigned long debounceDelay;
 
 extern int encoderBuffer[N_ENCODERS];
-extern bool midiDataPending;
+
+// Fader feedback from the plugin (CC 6-13) that matches one of the encoder's last ENCODER_ECHO_HISTORY
+// sent values (within ENCODER_ECHO_WINDOW_MS) is our own echo and dropped, at most once per sent value.
+// Any other value is an external change, held while the encoder is being turned and applied once it has
+// been idle this long
+const unsigned long ENCODER_FEEDBACK_HOLDOFF_MS = 250;
+const int ENCODER_ECHO_HISTORY = 16;
+const unsigned long ENCODER_ECHO_WINDOW_MS = 1000;
 
 // ================================
 // ADJUSTMENT MODE (BRIGHTNESS & SENSITIVITY)
@@ -136,4 +186,87 @@ extern bool sensitivityMode;          // True when actively adjusting sensitivit
 // ================================
 const int MAX_MESSAGES_PER_LOOP = 32; // Process up to 32 messages per loop
 
+// USB MIDI virtual cables (teensy41_4port env, USB_MIDI4_SERIAL: the host sees ports 1-4)
+// The default env is USB_MIDI_SERIAL, one port, so everything arrives on cable 0 (control ring)
+// Cable 0 (port 1): control, encoder and button output for Pro Plugins MidiEncoders and grandMA3 remotes
+// Cable 1 (port 2): plugin feedback and bulk state, cables 2-3 are handled the same way
+// Each has its own receive ring and the control ring is handled first, so a burst of page data can't hold
+// back anything on the control cable. Everything still works on cable 0 alone.
+const int MIDI_CABLES = 2;                    // Receive rings: control, feedback
+const byte MIDI_CABLE_CONTROL = 0;
+const byte MIDI_CABLE_FEEDBACK = 1;
+const unsigned long MIDI_CABLE_RATE_WINDOW_MS = 1000;  // Per cable messages per second window
+
+// Receive rings between usbMIDI and the handlers, messages stay in the USB buffers (host is NAKed) when full
+const int MIDI_RX_RING_SIZE = 128;    // Per cable ring
+const int MIDI_CREDIT_RESERVE = 8;    // Ring slots held back from advertised credits (credit requests, stray traffic)
+
+// Outgoing queue, flushed once per loop pass: button notes and encoder motion first, link traffic after
+// Absolute CCs keep only the last value per (channel, CC), relative encoder deltas are summed
+const int MIDI_TX_QUEUE_SIZE = 64;            // Entries per priority, a full queue is flushed early
+const int MIDI_MESSAGES_PER_PACKET = 16;      // 4 byte USB MIDI events per 64 byte full speed packet
+const int RELATIVE_CC_MAX_STEP = 10;          // Largest summed relative step (Pro Plugins MidiEncoders limit)
+
+// ================================
+// SERIAL COMMANDS
+// ================================
+const int SERIAL_COMMAND_MAX_LENGTH = 64;     // Longer lines are discarded
+const int SERIAL_COMMAND_MAX_ARGS = 5;        // Command plus up to 4 arguments
+const int SERIAL_CHARS_PER_POLL = 32;         // Characters read per checkSerialForReboot() call
+
+// ================================
+// LOOP WATCHDOG
+// ================================
+// Time spent in one loop() subsystem before it counts as a stall (a 58 pixel show takes ~1.8ms)
+const unsigned long LOOP_STALL_THRESHOLD_US = 5000;
+// Hardware watchdog (WDOG1), fed once per loop pass, both in 500ms steps
+const unsigned long WATCHDOG_TIMEOUT_MS = 2000;   // No loop pass for this long resets the Teensy
+const unsigned long WATCHDOG_WARNING_MS = 500;    // Post-mortem snapshot taken this long before the reset
+
+// ================================
+// LOW POWER IDLE
+// ================================
+// With nothing pending at the end of a pass, loop() waits for the next interrupt (USB, encoder or
+// button pin, 1ms SysTick) instead of spinning, switched at runtime with the IDLE serial command
+const bool IDLE_SLEEP_DEFAULT = true;
+const unsigned long IDLE_STATS_WINDOW_MS = 1000;  // CPU busy percentage window
+
+// ================================
+// FLIGHT RECORDER
+// ================================
+// Ring of timestamped input, MIDI and LED events, dumped with RECORDER DUMP (tools/flight_recorder_decode.py)
+const int FLIGHT_RECORDER_SIZE = 2048;        // Records (8 bytes each), power of two
+
+// ================================
+// WING LINK (MIDI CHANNEL 4)
+// ================================
+// Link between the firmware and the grandMA3 plugin
+// Requests are answered on the cable they came in on, credits are for that cable's receive ring
+// Plugin → Wing: CC 1 = request receive credits (request number 1-127), CC 2 = request page digests (request number 1-127)
+//                CC 3 = ping (ID 1-127)
+// Wing → Plugin: CC 1 = receive credits (free ring slots, 0-127), CC 2 = grant (the credit request number it answers)
+//                CC 4-7 = current page digests (low 7 bits), CC 10-13 = the same digests (high 7 bits),
+//                CC 3 = request number they answer (sent last)
+//                CC 8 = receive ring depth when the ping was handled, CC 9 = ping ID (sent last)
+// The plugin only spends credits whose grant matches its outstanding request, so the unrequested keepalive
+// (grant 0) or a late answer to an older request can't advertise slots a burst in flight is about to fill
+// The plugin requests digests with each page change: one 14 bit digest per group of XKeys covering what the
+// page cache holds (status, RGB when populated, encoder fader value). It compares them with its own and
+// only resends the groups that differ, and takes a matching group as its cache. 7 bits would let a group
+// that differs match 1 time in 128 and leave its XKeys wrong until they change again.
+const byte LINK_MIDI_CHANNEL = 4;
+const byte LINK_CC_CREDITS = 1;
+const byte LINK_CC_GRANT = 2;
+const byte LINK_GRANT_UNREQUESTED = 0;        // Grant of the startup and keepalive advertisements
+const byte LINK_CC_DIGEST_REQUEST = 2;
+const byte LINK_CC_DIGEST_NUMBER = 3;
+const byte LINK_CC_DIGEST = 4;                // First of PAGE_DIGEST_GROUPS CCs, low 7 bits
+const byte LINK_CC_DIGEST_HIGH = 10;          // First of PAGE_DIGEST_GROUPS CCs, high 7 bits
+const byte LINK_CC_PING = 3;
+const byte LINK_CC_PONG_DEPTH = 8;
+const byte LINK_CC_PONG = 9;
+const int PAGE_DIGEST_GROUPS = 4;
+const int PAGE_DIGEST_KEYS = (NUM_XKEYS + PAGE_DIGEST_GROUPS - 1) / PAGE_DIGEST_GROUPS;
+const unsigned long MIDI_CREDIT_KEEPALIVE_MS = 1000; // Unrequested advertisement interval
+
 #endif // CONFIG_H
\ No newline at end of file
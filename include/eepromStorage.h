@@ -23,6 +23,12 @@ struct ConfigData {
   float offBrightness;                   // Default 0.05
   float logoBrightness;                  // Default 1.0
   
+  // XKey encoder level shown on the LEDs while turning (FaderLevelDisplay in config.h)
+  int faderLevelDisplay;                 // 0 off, 1 key brightness, 2 bar across the row, default 0
+  
+  // Wing channel block, the wing uses MIDI channels base+1 to base+4 (the plugin's channelBase)
+  int midiChannelBase;                   // 0-12, default 0 (channels 1-4)
+  
 };
 
 // Default configuration values
@@ -14,4 +14,14 @@ void handleEncoders();
 void handleButtons();
 void sendMidiEncoder(int index, int direction);
 
+// Fader feedback for absolute encoders, held off while the encoder is being turned
+void setEncoderFeedback(int index, int value);
+void serviceEncoderFeedback();
+
+// Page change: absolute encoders take the new page's cached fader values, feedback then confirms or corrects them
+void loadPageEncoderValues();
+// Fader feedback for a page that isn't shown (prefetch), stored for its next page load
+void storeBackgroundEncoderValue(int page, int index, int value);
+void printEncoderStats();
+
 #endif // ENCODERS_H
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ================================
+// FLIGHT RECORDER
+// ================================
+// Always on ring buffer of the last FLIGHT_RECORDER_SIZE events, oldest overwritten first
+// Recording is a timestamp and two word stores, so the calls can stay in the hot paths
+
+static_assert((FLIGHT_RECORDER_SIZE & (FLIGHT_RECORDER_SIZE - 1)) == 0, "FLIGHT_RECORDER_SIZE must be a power of two");
+
+// Event types and their data bytes (keep tools/flight_recorder_decode.py in step)
+enum FlightEventType : uint8_t {
+  FLIGHT_BOOT = 1,        // -
+  FLIGHT_ENCODER = 2,     // encoder index, direction (int8), -
+  FLIGHT_BUTTON = 3,      // button index, 1 = pressed / 0 = released, -
+  FLIGHT_MIDI_IN = 4,     // status byte, data1, data2
+  FLIGHT_MIDI_OUT = 5,    // status byte, data1, data2
+  FLIGHT_PAGE = 6,        // new page, old page (1-127), -
+  FLIGHT_LED_FRAME = 7,   // 1 = forced, latency us (uint16)
+  FLIGHT_STALL = 8        // loop subsystem, duration ms (uint16)
+};
+
+// 8 bytes, dumped as is (little endian)
+struct FlightRecord {
+  uint32_t timeUs;        // micros()
+  uint8_t type;
+  uint8_t data[3];
+};
+
+extern FlightRecord flightRecords[FLIGHT_RECORDER_SIZE];
+extern uint32_t flightRecordCount;     // Events recorded since boot, the ring index is the low bits
+extern bool flightRecorderPaused;      // Set while a dump is running so the ring holds still
+
+static inline void recordFlightEvent(uint8_t type, uint8_t a, uint8_t b, uint8_t c) {
+  if (flightRecorderPaused) return;
+  FlightRecord* record = &flightRecords[flightRecordCount & (FLIGHT_RECORDER_SIZE - 1)];
+  record->timeUs = micros();
+  record->type = type;
+  record->data[0] = a;
+  record->data[1] = b;
+  record->data[2] = c;
+  flightRecordCount++;
+}
+
+// Events with a 16 bit value in the last two data bytes (low byte first)
+static inline void recordFlightEvent16(uint8_t type, uint8_t a, uint32_t value) {
+  if (value > 0xFFFF) value = 0xFFFF;
+  recordFlightEvent(type, a, (uint8_t)(value & 0xFF), (uint8_t)(value >> 8));
+}
+
+// RECORDER DUMP: binary dump of the ring, written a bit per call while the serial TX buffer has room
+void startFlightRecorderDump();
+// Returns true while a dump is still running
+bool serviceFlightRecorderDump();
+void clearFlightRecorder();
+void printFlightRecorderStats();
+
+#endif // FLIGHT_RECORDER_H
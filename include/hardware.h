@@ -0,0 +1,329 @@
+#ifndef HARDWARE_H
+#define HARDWARE_H
+
+#include <stdint.h>
+#include <type_traits>
+
+// ================================
+// HARDWARE LAYOUT DESCRIPTION
+// ================================
+// Everything that differs between board builds lives in one layout type: pins, encoder roles,
+// MIDI note/CC numbers and the NeoPixel map. The firmware only sees `Hardware` (selected at the
+// bottom of this file), so another board is a new layout struct, not a code fork.
+//
+// Layouts are checked with static_assert and turned into lookup tables (hw) at compile time.
+// Tables live in constexpr functions because C++14 can't define static constexpr array members in a header.
+
+// What an encoder sends
+enum EncoderRole : uint8_t {
+  ENCODER_RELATIVE,   // Attribute encoder, Pro Plugins MidiEncoders relative mode 3
+  ENCODER_ABSOLUTE    // XKey encoder, absolute 0-127 with fader feedback on the same CC
+};
+
+// What an encoder adjusts while the encoder flip button is held
+enum AdjustFunction : uint8_t {
+  ADJUST_NONE,
+  ADJUST_RELATIVE_SENSITIVITY,
+  ADJUST_ABSOLUTE_SENSITIVITY,
+  ADJUST_LOGO_BRIGHTNESS,
+  ADJUST_OFF_BRIGHTNESS,
+  ADJUST_ON_BRIGHTNESS
+};
+
+struct EncoderSpec {
+  uint8_t pinA;
+  uint8_t pinB;
+  uint8_t buttonPin;        // Encoder click
+  uint8_t cc;               // Channel 1 CC sent on turns (absolute encoders also receive feedback on it)
+  uint8_t note;             // Channel 1 note sent on clicks
+  EncoderRole role;
+  AdjustFunction adjust;
+  int8_t xkey;              // XKey index an absolute encoder controls, -1 for attribute encoders
+};
+
+struct XKeySpec {
+  uint8_t firstPixel;       // The two NeoPixels behind the key
+  uint8_t secondPixel;
+  uint16_t executor;        // grandMA3 executor the plugin maps to this key (debug output)
+};
+
+// ================================
+// EVOCMDWING V0.2
+// ================================
+// 5 attribute encoders, 8 XKey encoders (XKeys 1-8), encoder flip button, 16 XKeys in 2 rows of 8
+// Strip: [6 logo pixels][skip][2 xkey1 LEDs][skip][2 xkey2 LEDs]... with 2 skips after XKeys 4 and 12
+struct LayoutV02 {
+  static constexpr const char* name() { return "V0.2"; }
+
+  enum : int {
+    LED_PIN = 10,             // NeoPixel data pin
+    LATCH_LED_PIN = 13,       // Encoder flip (inner/outer) status LED
+    FLIP_BUTTON_PIN = 41,
+    FLIP_BUTTON_NOTE = 14,
+    NUM_ENCODERS = 13,
+    NUM_XKEYS = 16,
+    XKEY_COLUMNS = 8,
+    NUM_LOGO_PIXELS = 6,
+    TOTAL_PIXELS = 58
+  };
+
+  static constexpr EncoderSpec encoder(int i) {
+    constexpr EncoderSpec ENCODERS[NUM_ENCODERS] = {
+      // pinA pinB button cc note  role              adjust (flip held)           xkey
+      {  0,  1,  28,  1,  1,  ENCODER_RELATIVE, ADJUST_NONE,                 -1 },
+      {  2,  3,  29,  2,  2,  ENCODER_RELATIVE, ADJUST_NONE,                 -1 },
+      {  4,  5,  30,  3,  3,  ENCODER_RELATIVE, ADJUST_NONE,                 -1 },
+      {  6,  7,  31,  4,  4,  ENCODER_RELATIVE, ADJUST_NONE,                 -1 },
+      {  8,  9,  32,  5,  5,  ENCODER_RELATIVE, ADJUST_RELATIVE_SENSITIVITY, -1 },
+      { 11, 12,  33,  6,  6,  ENCODER_ABSOLUTE, ADJUST_ABSOLUTE_SENSITIVITY,  0 },
+      { 14, 15,  34,  7,  7,  ENCODER_ABSOLUTE, ADJUST_NONE,                  1 },
+      { 16, 17,  35,  8,  8,  ENCODER_ABSOLUTE, ADJUST_NONE,                  2 },
+      { 18, 19,  36,  9,  9,  ENCODER_ABSOLUTE, ADJUST_NONE,                  3 },
+      { 20, 21,  37, 10, 10,  ENCODER_ABSOLUTE, ADJUST_NONE,                  4 },
+      { 22, 23,  38, 11, 11,  ENCODER_ABSOLUTE, ADJUST_LOGO_BRIGHTNESS,       5 },
+      { 24, 25,  39, 12, 12,  ENCODER_ABSOLUTE, ADJUST_OFF_BRIGHTNESS,        6 },
+      { 26, 27,  40, 13, 13,  ENCODER_ABSOLUTE, ADJUST_ON_BRIGHTNESS,         7 }
+    };
+    return ENCODERS[i];
+  }
+
+  static constexpr XKeySpec xkey(int i) {
+    constexpr XKeySpec XKEYS[NUM_XKEYS] = {
+      {  7,  8, 291 }, { 10, 11, 292 }, { 13, 14, 293 }, { 16, 17, 294 },   // XKeys 1-4
+      { 20, 21, 295 }, { 23, 24, 296 }, { 26, 27, 297 }, { 29, 30, 298 },   // XKeys 5-8
+      { 32, 33, 191 }, { 35, 36, 192 }, { 38, 39, 193 }, { 41, 42, 194 },   // XKeys 9-12
+      { 45, 46, 195 }, { 48, 49, 196 }, { 51, 52, 197 }, { 54, 55, 198 }    // XKeys 13-16
+    };
+    return XKEYS[i];
+  }
+};
+
+// ================================
+// 24 XKEY VARIANT
+// ================================
+// V0.2 controls with a third row of 8 XKeys (executors 391-398) chained on the same strip
+// Status/RGB CCs follow the key count (status CC 1-24, RGB CC 25-96), the plugin has to be set up to match
+struct LayoutXKey24 {
+  static constexpr const char* name() { return "V0.2 24 XKey"; }
+
+  enum : int {
+    LED_PIN = LayoutV02::LED_PIN,
+    LATCH_LED_PIN = LayoutV02::LATCH_LED_PIN,
+    FLIP_BUTTON_PIN = LayoutV02::FLIP_BUTTON_PIN,
+    FLIP_BUTTON_NOTE = LayoutV02::FLIP_BUTTON_NOTE,
+    NUM_ENCODERS = LayoutV02::NUM_ENCODERS,
+    NUM_XKEYS = 24,
+    XKEY_COLUMNS = 8,
+    NUM_LOGO_PIXELS = LayoutV02::NUM_LOGO_PIXELS,
+    TOTAL_PIXELS = 83
+  };
+
+  static constexpr EncoderSpec encoder(int i) {
+    return LayoutV02::encoder(i);
+  }
+
+  static constexpr XKeySpec xkey(int i) {
+    constexpr XKeySpec THIRD_ROW[8] = {
+      { 57, 58, 391 }, { 60, 61, 392 }, { 63, 64, 393 }, { 66, 67, 394 },   // XKeys 17-20
+      { 70, 71, 395 }, { 73, 74, 396 }, { 76, 77, 397 }, { 79, 80, 398 }    // XKeys 21-24
+    };
+    return (i < LayoutV02::NUM_XKEYS) ? LayoutV02::xkey(i) : THIRD_ROW[i - LayoutV02::NUM_XKEYS];
+  }
+};
+
+// ================================
+// LAYOUT VALIDATION
+// ================================
+
+// Buttons are the encoder clicks followed by the encoder flip button
+template <typename L>
+constexpr int layoutButtonPin(int i) {
+  return (i < L::NUM_ENCODERS) ? (int)L::encoder(i).buttonPin : (int)L::FLIP_BUTTON_PIN;
+}
+
+template <typename L>
+constexpr int layoutButtonNote(int i) {
+  return (i < L::NUM_ENCODERS) ? (int)L::encoder(i).note : (int)L::FLIP_BUTTON_NOTE;
+}
+
+// No GPIO pin used twice
+template <typename L>
+constexpr bool layoutPinsUnique() {
+  bool used[64] = {};
+  const int fixed[2] = {L::LED_PIN, L::LATCH_LED_PIN};
+  for (int i = 0; i < 2; i++) {
+    if (used[fixed[i]]) return false;
+    used[fixed[i]] = true;
+  }
+  for (int i = 0; i < L::NUM_ENCODERS; i++) {
+    const int pins[2] = {L::encoder(i).pinA, L::encoder(i).pinB};
+    for (int p = 0; p < 2; p++) {
+      if (pins[p] >= 64 || used[pins[p]]) return false;
+      used[pins[p]] = true;
+    }
+  }
+  for (int i = 0; i <= L::NUM_ENCODERS; i++) {
+    int pin = layoutButtonPin<L>(i);
+    if (pin >= 64 || used[pin]) return false;
+    used[pin] = true;
+  }
+  return true;
+}
+
+// Encoder CCs and button notes are distinct 1-127
+template <typename L>
+constexpr bool layoutMidiUnique() {
+  bool ccUsed[128] = {};
+  bool noteUsed[128] = {};
+  for (int i = 0; i < L::NUM_ENCODERS; i++) {
+    int cc = L::encoder(i).cc;
+    if (cc < 1 || cc > 127 || ccUsed[cc]) return false;
+    ccUsed[cc] = true;
+  }
+  for (int i = 0; i <= L::NUM_ENCODERS; i++) {
+    int note = layoutButtonNote<L>(i);
+    if (note < 1 || note > 127 || noteUsed[note]) return false;
+    noteUsed[note] = true;
+  }
+  return true;
+}
+
+// Absolute encoders each control a different XKey, attribute encoders none, adjust functions used once
+template <typename L>
+constexpr bool layoutRolesValid() {
+  bool xkeyUsed[L::NUM_XKEYS] = {};
+  bool adjustUsed[ADJUST_ON_BRIGHTNESS + 1] = {};
+  for (int i = 0; i < L::NUM_ENCODERS; i++) {
+    EncoderSpec e = L::encoder(i);
+    if (e.role == ENCODER_RELATIVE && e.xkey != -1) return false;
+    if (e.role == ENCODER_ABSOLUTE) {
+      if (e.xkey < 0 || e.xkey >= L::NUM_XKEYS || xkeyUsed[e.xkey]) return false;
+      xkeyUsed[e.xkey] = true;
+    }
+    if (e.adjust != ADJUST_NONE) {
+      if (adjustUsed[e.adjust]) return false;
+      adjustUsed[e.adjust] = true;
+    }
+  }
+  return true;
+}
+
+// XKey pixels sit after the logo, inside the strip, and never overlap
+template <typename L>
+constexpr bool layoutPixelsValid() {
+  bool used[256] = {};
+  for (int i = 0; i < L::NUM_XKEYS; i++) {
+    const int pixels[2] = {L::xkey(i).firstPixel, L::xkey(i).secondPixel};
+    for (int p = 0; p < 2; p++) {
+      if (pixels[p] < L::NUM_LOGO_PIXELS || pixels[p] >= L::TOTAL_PIXELS || used[pixels[p]]) return false;
+      used[pixels[p]] = true;
+    }
+  }
+  return true;
+}
+
+template <typename L>
+constexpr bool validateLayout() {
+  static_assert(L::NUM_ENCODERS > 0 && L::NUM_ENCODERS < 64, "Encoder count out of range");
+  static_assert(L::TOTAL_PIXELS <= 256, "Pixel map uses 8 bit indexes");
+  static_assert(L::NUM_XKEYS <= 32, "XKey masks are 32 bit");
+  static_assert(L::NUM_XKEYS * 4 <= 127, "Status (1 CC) and RGB (3 CCs) per XKey must fit in CC 1-127");
+  static_assert(L::XKEY_COLUMNS == 8 && L::NUM_XKEYS % L::XKEY_COLUMNS == 0 && L::NUM_XKEYS / L::XKEY_COLUMNS >= 2,
+                "XKeys must be rows of 8, at least 2 rows (sensitivity display shows levels 1-8 on rows 1 and 2)");
+  return layoutPinsUnique<L>() && layoutMidiUnique<L>() && layoutRolesValid<L>() && layoutPixelsValid<L>();
+}
+
+// ================================
+// LOOKUP TABLES
+// ================================
+// Built from the layout at compile time, indexed at runtime (MIDI handlers, LED map)
+template <typename L>
+struct HardwareTables {
+  EncoderSpec encoders[L::NUM_ENCODERS];
+  XKeySpec xkeys[L::NUM_XKEYS];
+  uint8_t buttonPins[L::NUM_ENCODERS + 1];
+  uint8_t buttonNotes[L::NUM_ENCODERS + 1];
+  int8_t feedbackEncoder[128];    // Channel 1 CC → absolute encoder index, -1 for none
+  int8_t statusXKey[128];         // Channel 2 CC → XKey index for status CCs, -1 for none
+  int8_t colorXKey[128];          // Channel 2 CC → XKey index for RGB CCs, -1 for none
+  int8_t colorComponent[128];     // Channel 2 CC → 0=Red, 1=Green, 2=Blue
+  int8_t xkeyEncoder[L::NUM_XKEYS]; // XKey index → absolute encoder index, -1 for none
+};
+
+template <typename L>
+constexpr HardwareTables<L> buildHardwareTables() {
+  HardwareTables<L> t = {};
+  for (int cc = 0; cc < 128; cc++) {
+    t.feedbackEncoder[cc] = -1;
+    t.statusXKey[cc] = -1;
+    t.colorXKey[cc] = -1;
+    t.colorComponent[cc] = 0;
+  }
+  for (int i = 0; i < L::NUM_XKEYS; i++) {
+    t.xkeyEncoder[i] = -1;
+  }
+  for (int i = 0; i < L::NUM_ENCODERS; i++) {
+    t.encoders[i] = L::encoder(i);
+    if (t.encoders[i].role == ENCODER_ABSOLUTE) {
+      t.feedbackEncoder[t.encoders[i].cc] = (int8_t)i;
+      t.xkeyEncoder[t.encoders[i].xkey] = (int8_t)i;
+    }
+  }
+  for (int i = 0; i <= L::NUM_ENCODERS; i++) {
+    t.buttonPins[i] = (uint8_t)layoutButtonPin<L>(i);
+    t.buttonNotes[i] = (uint8_t)layoutButtonNote<L>(i);
+  }
+  // Status on CC 1-N, then RGB triplets
+  for (int i = 0; i < L::NUM_XKEYS; i++) {
+    t.xkeys[i] = L::xkey(i);
+    t.statusXKey[1 + i] = (int8_t)i;
+    for (int c = 0; c < 3; c++) {
+      int cc = 1 + L::NUM_XKEYS + i * 3 + c;
+      t.colorXKey[cc] = (int8_t)i;
+      t.colorComponent[cc] = (int8_t)c;
+    }
+  }
+  return t;
+}
+
+// ================================
+// COMPILE TIME LOOPS
+// ================================
+// staticFor<N>(f) calls f(std::integral_constant<int, I>()) for I = 0..N-1, fully unrolled.
+// Use a generic lambda and decltype(i)::value to get the index as a constant expression.
+template <int I, int N>
+struct StaticFor {
+  template <typename F>
+  static inline __attribute__((always_inline)) void run(F& f) {
+    f(std::integral_constant<int, I>());
+    StaticFor<I + 1, N>::run(f);
+  }
+};
+
+template <int N>
+struct StaticFor<N, N> {
+  template <typename F>
+  static inline __attribute__((always_inline)) void run(F&) {}
+};
+
+template <int N, typename F>
+inline __attribute__((always_inline)) void staticFor(F f) {
+  StaticFor<0, N>::run(f);
+}
+
+// ================================
+// SELECTED LAYOUT
+// ================================
+// Build flag -D EVOCMDWING_LAYOUT_XKEY24 selects the 24 XKey variant, V0.2 otherwise
+#if defined(EVOCMDWING_LAYOUT_XKEY24)
+typedef LayoutXKey24 Hardware;
+#else
+typedef LayoutV02 Hardware;
+#endif
+
+static_assert(validateLayout<Hardware>(), "Invalid hardware layout (pins, MIDI numbers, encoder roles or pixel map)");
+
+// Lookup tables for the selected layout (hardware.cpp)
+extern const HardwareTables<Hardware> hw;
+
+#endif // HARDWARE_H
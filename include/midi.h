@@ -11,5 +11,30 @@
 void handleIncomingMIDI();
 void handleStatusMIDI(byte ch, byte cc, byte value);
 void handlePageMIDI(byte ch, byte cc, byte value);
+// LED effect (effect * 16 + rate) and phase of an XKey on a page, from channel 3 or the EFFECT command
+void setExecutorEffect(int page, int xkeyIndex, byte value, byte phase);
+void handleLinkMIDI(byte ch, byte cc, byte value, byte cable);
+
+// Outgoing queue, flushed by flushMidiOutput() once per loop pass
+enum MidiTxPriority {
+  MIDI_TX_HIGH = 0,   // Button notes and encoder motion, always on the control cable
+  MIDI_TX_LOW = 1     // Link traffic (credits), on the cable the plugin's request came in on
+};
+void queueNoteOn(byte note, byte velocity, byte channel);
+void queueAbsoluteCC(byte cc, byte value, byte channel);                   // Last value wins
+void queueRelativeCC(byte cc, byte value, byte channel);                   // Deltas summed (1-63 up, 65-127 down)
+void queueControlChange(byte cc, byte value, byte channel, MidiTxPriority priority, byte cable);  // Sent as is
+void flushMidiOutput();
+
+// Receive rings and credits
+int midiRxFree();   // Feedback ring
+// Messages waiting in the receive ring or outgoing queue, or credits to advertise
+bool midiWorkPending();
+void sendMidiCredits();
+
+// Page digests, one per group of PAGE_DIGEST_KEYS XKeys
+uint16_t pageGroupDigest(int page, int group);   // 14 bits
+void sendPageDigests(int page, byte requestNumber, byte cable);
+void printMidiStats();
 
 #endif // MIDI_H
\ No newline at end of file
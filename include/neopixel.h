@@ -14,6 +14,14 @@ void initializeLEDs();
 void updateXKeyLEDs();
 void setXKeyLED(int xkeyIndex, uint8_t red, uint8_t green, uint8_t blue, float brightness);
 
+// Sets an XKey's LEDs from its executor status on the current page (off / offBrightness / onBrightness)
+void renderXKeyStatus(int xkeyIndex, const ExecutorStatus* status);
+// Loads a page's XKey colors into the strip buffer, rendered once per page and brightness
+void loadPageLEDs(int page);
+// Keeps another page's cache entry in step with background (prefetched) status data, nothing is shown
+void cachePageXKeyStatus(int page, int xkeyIndex, const ExecutorStatus* status);
+void benchmarkPageFlips(int flips);
+
 // Converts RGB to HSV and scales value, then returns scaled RGB color
 uint32_t getScaledColor(uint8_t red, uint8_t green, uint8_t blue, float brightness);
 
@@ -24,4 +32,35 @@ void showStrip();
 
 void updateSensitivityLEDs();
 
+// ================================
+// LED FRAME SCHEDULER FUNCTIONS
+// ================================
+
+// Status CC applied to an XKey, expectColor when an RGB triplet will follow (newly populated)
+void markXKeyStatusPending(int xkeyIndex, bool expectColor);
+// One RGB component (0=Red, 1=Green, 2=Blue) applied to an XKey
+void markXKeyColorPending(int xkeyIndex, int component);
+// Whole strip changed (page change, brightness), show on the next allowed frame
+void requestLEDFrame();
+// Drops partial RGB tracking, used when the data it belonged to is no longer displayed
+void resetLEDFrameTracking();
+// Called from loop(), shows the strip when pending changes are consistent or too old
+void serviceLEDFrame();
+void printLEDFrameStats();
+
+// ================================
+// LED EFFECT FUNCTIONS
+// ================================
+
+// Loads the effect slots of a page's XKeys, called before the page is shown
+void loadPageEffects(int page);
+// Effect of an XKey on the current page changed, shown on the next frame
+void setXKeyEffect(int xkeyIndex, const ExecutorStatus* status);
+// Called from loop(), redraws blinking, pulsing, flashing and fading XKeys once per LED_EFFECT_FRAME_MS
+void serviceLEDEffects();
+const char* ledEffectName(int effect);
+
+// Absolute XKey encoder turned, shows its value on the XKey (or its row) per config.faderLevelDisplay
+void showFaderLevel(int xkeyIndex, int value);
+
 #endif // NEOPIXEL_H
\ No newline at end of file
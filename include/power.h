@@ -0,0 +1,25 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ================================
+// LOW POWER IDLE FUNCTIONS
+// ================================
+
+// Called from setup() after initializeEncoders(), lets button presses wake the core
+void initializeIdle();
+// Called at the top of loop(), before any input is polled
+void beginLoopPass();
+// Called at the end of loop(), sleeps until the next interrupt when no work is left
+void idleUntilWork();
+
+// An encoder detent, button edge or MIDI message was handled, closes the wake-to-handle measurement
+void noteInputHandled();
+
+void setIdleSleep(bool enabled);
+bool idleSleepEnabled();
+void printIdleStats();
+
+#endif // POWER_H
@@ -14,7 +14,29 @@ extern bool debugMode;
 void debugPrint(const char* message);
 void debugPrintf(const char* format, ...);
 
+// Trace categories for per message debug output, switched with the TRACE serial command
+enum TraceCategory : uint16_t {
+  TRACE_MIDI_IN = 1 << 0,   // Channel 1 fader feedback, channel 4 link requests
+  TRACE_STATUS  = 1 << 1,   // Channel 2 XKey status and RGB
+  TRACE_PAGE    = 1 << 2,   // Channel 3 page changes
+  TRACE_ENCODER = 1 << 3,   // Encoder turns and held feedback
+  TRACE_BUTTON  = 1 << 4,   // Button notes
+  TRACE_LED     = 1 << 5,   // LED frame scheduler
+  TRACE_ALL     = 0x3F
+};
+extern uint16_t traceMask;
+
+// debugPrintf() for one trace category, skipped before formatting when the category is off
+void tracePrintf(uint16_t category, const char* format, ...);
+
+//================================
+// SERIAL COMMANDS
+//================================
+
+// Called from loop(), reads a bounded number of characters and runs at most one command
 void checkSerialForReboot();
-void processSerialCommand(String cmd);
+void processSerialCommand(char* line);
+// Characters waiting or a dump still running
+bool serialWorkPending();
 
 #endif // UTILS_H
\ No newline at end of file
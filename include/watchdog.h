@@ -0,0 +1,38 @@
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ================================
+// LOOP WATCHDOG FUNCTIONS
+// ================================
+
+// Part of the firmware currently running, marked from loop() so stalls can be attributed
+enum LoopSubsystem : uint8_t {
+  SUBSYSTEM_STARTUP = 0,  // setup(), including the boot animation
+  SUBSYSTEM_IDLE,         // Between loop passes (low power idle, host wait)
+  SUBSYSTEM_MIDI_IN,
+  SUBSYSTEM_ENCODERS,
+  SUBSYSTEM_BUTTONS,
+  SUBSYSTEM_MIDI_OUT,
+  SUBSYSTEM_LED_FRAME,
+  SUBSYSTEM_SERIAL,
+  SUBSYSTEM_EEPROM,
+  SUBSYSTEM_COUNT
+};
+
+// Called first in setup(), picks up the post-mortem left by the previous run
+void initializeWatchdog();
+// Called at the end of setup(), arms the hardware watchdog
+void startWatchdog();
+// Called at the top of loop(), feeds the hardware watchdog and measures the loop period
+void serviceWatchdog();
+
+// Closes the running subsystem (recording a stall if it took too long) and starts the next one
+// Returns the subsystem that was running, so nested work (EEPROM writes) can restore it
+LoopSubsystem markSubsystem(LoopSubsystem subsystem);
+
+void printWatchdogStats();
+
+#endif // WATCHDOG_H
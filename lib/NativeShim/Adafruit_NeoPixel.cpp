@@ -0,0 +1,40 @@
+#include "Adafruit_NeoPixel.h"
+#include <stdlib.h>
+#include <string.h>
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type)
+  : numLEDs(n), brightness(255), pixels(nullptr), shows(0) {
+  (void)pin;
+  (void)type;
+  pixels = (uint8_t*)calloc(n * 3, 1);
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel() {
+  free(pixels);
+}
+
+void Adafruit_NeoPixel::show() {
+  shows++;
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c) {
+  setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+  if (n >= numLEDs) return;
+  uint8_t* p = &pixels[n * 3];
+  p[0] = r;
+  p[1] = g;
+  p[2] = b;
+}
+
+uint32_t Adafruit_NeoPixel::getPixelColor(uint16_t n) const {
+  if (n >= numLEDs) return 0;
+  const uint8_t* p = &pixels[n * 3];
+  return Color(p[0], p[1], p[2]);
+}
+
+void Adafruit_NeoPixel::clear() {
+  memset(pixels, 0, numLEDs * 3);
+}
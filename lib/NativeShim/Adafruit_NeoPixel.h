@@ -0,0 +1,46 @@
+#ifndef NATIVE_ADAFRUIT_NEOPIXEL_H
+#define NATIVE_ADAFRUIT_NEOPIXEL_H
+
+#include <stdint.h>
+
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+// ================================
+// NATIVE NEOPIXEL
+// ================================
+// Keeps the pixel buffer and counts show() calls, nothing is driven
+
+class Adafruit_NeoPixel {
+public:
+  Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type);
+  ~Adafruit_NeoPixel();
+
+  void begin() {}
+  void show();
+  bool canShow() const { return true; }
+  void setBrightness(uint8_t b) { brightness = b; }
+  uint8_t getBrightness() const { return brightness; }
+  void setPixelColor(uint16_t n, uint32_t c);
+  void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b);
+  uint32_t getPixelColor(uint16_t n) const;
+  uint8_t* getPixels() const { return pixels; }
+  uint16_t numPixels() const { return numLEDs; }
+  void clear();
+
+  static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  }
+
+  // Host side counters
+  unsigned long showCount() const { return shows; }
+
+private:
+  uint16_t numLEDs;
+  uint8_t brightness;
+  uint8_t* pixels;         // 3 bytes per pixel, R G B
+  unsigned long shows;
+};
+
+#endif // NATIVE_ADAFRUIT_NEOPIXEL_H
@@ -0,0 +1,150 @@
+#include "Arduino.h"
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// ================================
+// TIME
+// ================================
+
+static uint64_t monotonicMicros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static const uint64_t startMicros = monotonicMicros();
+
+unsigned long millis() {
+  return (unsigned long)((monotonicMicros() - startMicros) / 1000ULL);
+}
+
+unsigned long micros() {
+  return (unsigned long)(monotonicMicros() - startMicros);
+}
+
+void delay(unsigned long ms) {
+  usleep((useconds_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  usleep(us);
+}
+
+void yield() {
+}
+
+// ================================
+// GPIO
+// ================================
+
+static const int NATIVE_PIN_COUNT = 64;
+static int pinModes[NATIVE_PIN_COUNT];
+static int pinValues[NATIVE_PIN_COUNT];
+
+void pinMode(int pin, int mode) {
+  if (pin < 0 || pin >= NATIVE_PIN_COUNT) return;
+  pinModes[pin] = mode;
+  // Pull-ups read HIGH until something pulls the pin low
+  if (mode == INPUT_PULLUP) pinValues[pin] = HIGH;
+}
+
+int digitalRead(int pin) {
+  if (pin < 0 || pin >= NATIVE_PIN_COUNT) return LOW;
+  return pinValues[pin];
+}
+
+void digitalWrite(int pin, int value) {
+  if (pin < 0 || pin >= NATIVE_PIN_COUNT) return;
+  pinValues[pin] = value ? HIGH : LOW;
+}
+
+// ================================
+// REBOOT
+// ================================
+
+volatile uint32_t SCB_AIRCR = 0;
+
+void _reboot_Teensyduino_() {
+  fflush(stdout);
+  exit(0);
+}
+
+// ================================
+// STRING
+// ================================
+
+void String::trim() {
+  size_t first = value.find_first_not_of(" \t\r\n");
+  if (first == std::string::npos) {
+    value.clear();
+    return;
+  }
+  size_t last = value.find_last_not_of(" \t\r\n");
+  value = value.substr(first, last - first + 1);
+}
+
+// ================================
+// SERIAL
+// ================================
+
+NativeSerial Serial;
+
+static int stdinPeeked = -1;
+
+void NativeSerial::begin(unsigned long baud) {
+  (void)baud;
+  int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
+  if (flags >= 0) fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+}
+
+int NativeSerial::peek() {
+  if (stdinPeeked < 0) {
+    unsigned char c;
+    if (::read(STDIN_FILENO, &c, 1) == 1) stdinPeeked = c;
+  }
+  return stdinPeeked;
+}
+
+int NativeSerial::available() {
+  return peek() >= 0 ? 1 : 0;
+}
+
+int NativeSerial::read() {
+  int c = peek();
+  stdinPeeked = -1;
+  return c;
+}
+
+void NativeSerial::flush() { fflush(stdout); }
+int NativeSerial::availableForWrite() { return 4096; }
+size_t NativeSerial::write(uint8_t b) { return fwrite(&b, 1, 1, stdout); }
+size_t NativeSerial::write(const uint8_t* buffer, size_t size) { return fwrite(buffer, 1, size, stdout); }
+
+size_t NativeSerial::print(const char* text) { return (size_t)fputs(text, stdout) >= 0 ? strlen(text) : 0; }
+size_t NativeSerial::print(const String& text) { return print(text.c_str()); }
+size_t NativeSerial::print(char c) { return write((uint8_t)c); }
+size_t NativeSerial::print(int value) { return (size_t)::printf("%d", value); }
+size_t NativeSerial::print(unsigned int value) { return (size_t)::printf("%u", value); }
+size_t NativeSerial::print(long value) { return (size_t)::printf("%ld", value); }
+size_t NativeSerial::print(unsigned long value) { return (size_t)::printf("%lu", value); }
+size_t NativeSerial::print(double value, int digits) { return (size_t)::printf("%.*f", digits, value); }
+
+size_t NativeSerial::println() { return print("\r\n"); }
+size_t NativeSerial::println(const char* text) { return print(text) + println(); }
+size_t NativeSerial::println(const String& text) { return print(text) + println(); }
+size_t NativeSerial::println(char c) { return print(c) + println(); }
+size_t NativeSerial::println(int value) { return print(value) + println(); }
+size_t NativeSerial::println(unsigned int value) { return print(value) + println(); }
+size_t NativeSerial::println(long value) { return print(value) + println(); }
+size_t NativeSerial::println(unsigned long value) { return print(value) + println(); }
+size_t NativeSerial::println(double value, int digits) { return print(value, digits) + println(); }
+
+int NativeSerial::printf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  int n = vprintf(format, args);
+  va_end(args);
+  return n;
+}
@@ -0,0 +1,108 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// ================================
+// NATIVE BUILD ARDUINO SHIM
+// ================================
+// Just enough of the Teensy 4.1 core for the EvoCmdWing firmware to build and run on Linux
+// Only used by [env:native], the Teensy build uses the real core (lib_ignore = NativeShim)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define PI 3.1415926535897932384626433832795
+
+// Teensy memory placement attributes have no meaning on the host
+#define DMAMEM
+#define FASTRUN
+#define FLASHMEM
+#define PROGMEM
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+template <class A, class B> inline auto min(A a, B b) -> decltype(a < b ? a : b) { return a < b ? a : b; }
+template <class A, class B> inline auto max(A a, B b) -> decltype(a > b ? a : b) { return a > b ? a : b; }
+
+// Time, from CLOCK_MONOTONIC since startup
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Simulated GPIO, inputs can be driven through the MIDI bridge
+void pinMode(int pin, int mode);
+int digitalRead(int pin);
+void digitalWrite(int pin, int value);
+inline int digitalReadFast(int pin) { return digitalRead(pin); }
+
+// Reboot requests end the native process
+void _reboot_Teensyduino_();
+extern volatile uint32_t SCB_AIRCR;
+
+// Minimal Arduino String (appending, trim, compare)
+class String {
+public:
+  String(const char* text = "") : value(text ? text : "") {}
+  String& operator+=(char c) { value += c; return *this; }
+  String& operator+=(const char* text) { value += text; return *this; }
+  bool operator==(const char* text) const { return value == text; }
+  bool operator!=(const char* text) const { return value != text; }
+  unsigned int length() const { return (unsigned int)value.size(); }
+  const char* c_str() const { return value.c_str(); }
+  void trim();
+private:
+  std::string value;
+};
+
+// Serial goes to stdout, input comes from a non-blocking stdin
+class NativeSerial {
+public:
+  void begin(unsigned long baud);
+  int available();
+  int read();
+  int peek();
+  void flush();
+  int availableForWrite();
+  size_t write(uint8_t b);
+  size_t write(const uint8_t* buffer, size_t size);
+  size_t print(const char* text);
+  size_t print(const String& text);
+  size_t print(char c);
+  size_t print(int value);
+  size_t print(unsigned int value);
+  size_t print(long value);
+  size_t print(unsigned long value);
+  size_t print(double value, int digits = 2);
+  size_t println();
+  size_t println(const char* text);
+  size_t println(const String& text);
+  size_t println(char c);
+  size_t println(int value);
+  size_t println(unsigned int value);
+  size_t println(long value);
+  size_t println(unsigned long value);
+  size_t println(double value, int digits = 2);
+  int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+  operator bool() const { return true; }
+};
+extern NativeSerial Serial;
+
+#include "usb_midi.h"
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,3 @@
+#include "EEPROM.h"
+
+NativeEEPROM EEPROM;
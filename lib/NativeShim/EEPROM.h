@@ -0,0 +1,39 @@
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ================================
+// NATIVE EEPROM
+// ================================
+// RAM backed, starts erased (0xFF) like a fresh Teensy, so the firmware loads its defaults
+
+class NativeEEPROM {
+public:
+  static const int SIZE = 4284;  // Teensy 4.1 emulated EEPROM size
+
+  NativeEEPROM() { memset(data, 0xFF, sizeof(data)); }
+
+  uint8_t read(int address) const { return (address >= 0 && address < SIZE) ? data[address] : 0xFF; }
+  void write(int address, uint8_t value) { if (address >= 0 && address < SIZE) data[address] = value; }
+  void update(int address, uint8_t value) { write(address, value); }
+  int length() const { return SIZE; }
+
+  template <typename T> T& get(int address, T& t) {
+    if (address >= 0 && address + (int)sizeof(T) <= SIZE) memcpy(&t, &data[address], sizeof(T));
+    return t;
+  }
+
+  template <typename T> const T& put(int address, const T& t) {
+    if (address >= 0 && address + (int)sizeof(T) <= SIZE) memcpy(&data[address], &t, sizeof(T));
+    return t;
+  }
+
+private:
+  uint8_t data[SIZE];
+};
+
+extern NativeEEPROM EEPROM;
+
+#endif // NATIVE_EEPROM_H
@@ -0,0 +1,22 @@
+#include "Encoder.h"
+
+static const int MAX_NATIVE_ENCODERS = 32;
+static Encoder* registeredEncoders[MAX_NATIVE_ENCODERS];
+static int registeredCount = 0;
+
+Encoder::Encoder(uint8_t pin1, uint8_t pin2) : position(0) {
+  (void)pin1;
+  (void)pin2;
+  if (registeredCount < MAX_NATIVE_ENCODERS) {
+    registeredEncoders[registeredCount++] = this;
+  }
+}
+
+Encoder* Encoder::byIndex(int index) {
+  if (index < 0 || index >= registeredCount) return nullptr;
+  return registeredEncoders[index];
+}
+
+int Encoder::count() {
+  return registeredCount;
+}
@@ -0,0 +1,28 @@
+#ifndef NATIVE_ENCODER_H
+#define NATIVE_ENCODER_H
+
+#include <stdint.h>
+
+// ================================
+// NATIVE ENCODER
+// ================================
+// Position is only changed by the bridge (nativeInjectEncoder), 4 counts per detent like the real encoders
+// Encoders are numbered in construction order, which matches the firmware's encoder index
+
+class Encoder {
+public:
+  Encoder(uint8_t pin1, uint8_t pin2);
+  int32_t read() const { return position; }
+  int32_t readAndReset() { int32_t p = position; position = 0; return p; }
+  void write(int32_t p) { position = p; }
+
+  // Bridge access
+  static Encoder* byIndex(int index);
+  static int count();
+  void inject(int32_t counts) { position += counts; }
+
+private:
+  volatile int32_t position;
+};
+
+#endif // NATIVE_ENCODER_H
@@ -0,0 +1,7 @@
+#ifndef NATIVE_MIDIUSB_H
+#define NATIVE_MIDIUSB_H
+
+// usbMIDI comes from the core (Arduino.h), kept so firmware includes resolve on the host
+#include "Arduino.h"
+
+#endif // NATIVE_MIDIUSB_H
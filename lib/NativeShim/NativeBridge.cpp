@@ -0,0 +1,299 @@
+#include "NativeBridge.h"
+#include "Arduino.h"
+#include "Encoder.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+usb_midi_class usbMIDI;
+
+static int listenFd = -1;
+static int clientFd = -1;
+static char boundPath[sizeof(((struct sockaddr_un*)0)->sun_path)];
+static NativeBridgeStats bridgeStats = {0, 0, 0, 0, 0, 0, 0};
+
+// Parsed messages waiting for usbMIDI.read()
+struct NativeMidiMessage {
+  uint8_t status;
+  uint8_t data1;
+  uint8_t data2;
+  uint8_t cable;
+};
+static const int RX_QUEUE_SIZE = 4096;
+static NativeMidiMessage rxQueue[RX_QUEUE_SIZE];
+static int rxHead = 0;
+static int rxTail = 0;
+static int rxCount = 0;
+
+// Raw MIDI parser state (running status, sysex skipped)
+static uint8_t runningStatus = 0;
+static uint8_t pendingData[2];
+static int pendingCount = 0;
+static bool inSysex = false;
+static bool cableSelect = false;   // 0xF5 seen, the next data byte is the cable
+static uint8_t rxCable = 0;
+
+// Outgoing bytes, written on send_now() or when a full packet's worth is waiting
+static const size_t TX_FLUSH_BYTES = 48;   // 16 events of 3 bytes, one full speed USB packet
+static uint8_t txBuffer[4096];
+static size_t txLength = 0;
+
+// ================================
+// CLIENT CONNECTION
+// ================================
+
+static void closeClient() {
+  if (clientFd >= 0) {
+    close(clientFd);
+    clientFd = -1;
+    printf("[BRIDGE] Client disconnected\n");
+  }
+  runningStatus = 0;
+  pendingCount = 0;
+  inSysex = false;
+  cableSelect = false;
+  rxCable = 0;
+  txLength = 0;
+}
+
+static void acceptClient() {
+  int fd = accept(listenFd, nullptr, nullptr);
+  if (fd < 0) return;
+  
+  // One client at a time, a new connection replaces the old one
+  closeClient();
+  clientFd = fd;
+  bridgeStats.clients++;
+  printf("[BRIDGE] Client connected\n");
+}
+
+bool nativeBridgeBegin(const char* socketPath) {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+  strncpy(boundPath, addr.sun_path, sizeof(boundPath) - 1);
+  
+  listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd < 0) {
+    perror("[BRIDGE] socket");
+    return false;
+  }
+  
+  unlink(socketPath);
+  if (bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, 1) < 0) {
+    perror("[BRIDGE] bind/listen");
+    close(listenFd);
+    listenFd = -1;
+    return false;
+  }
+  fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL, 0) | O_NONBLOCK);
+  
+  printf("[BRIDGE] Raw MIDI on unix socket %s\n", socketPath);
+  return true;
+}
+
+void nativeBridgeEnd() {
+  closeClient();
+  if (listenFd >= 0) {
+    close(listenFd);
+    listenFd = -1;
+    unlink(boundPath);
+  }
+}
+
+const NativeBridgeStats& nativeBridgeStats() {
+  return bridgeStats;
+}
+
+// ================================
+// INCOMING MIDI
+// ================================
+
+// Channel 16 drives the simulated encoders and buttons instead of reaching the firmware
+static bool injectInput(uint8_t status, uint8_t data1, uint8_t data2) {
+  if ((status & 0x0F) != (NATIVE_INJECT_CHANNEL - 1)) return false;
+  
+  uint8_t type = status & 0xF0;
+  if (type == usb_midi_class::ControlChange) {
+    Encoder* encoder = Encoder::byIndex(data1);
+    int detents = (int)data2 - 64;
+    if (encoder && detents != 0) {
+      encoder->inject(detents * 4);
+      bridgeStats.injectedDetents += (unsigned long)abs(detents);
+    }
+    return true;
+  }
+  if (type == usb_midi_class::NoteOn || type == usb_midi_class::NoteOff) {
+    bool pressed = (type == usb_midi_class::NoteOn) && data2 > 0;
+    digitalWrite(data1, pressed ? LOW : HIGH);
+    bridgeStats.injectedButtons++;
+    return true;
+  }
+  return true;  // Other channel 16 traffic is ignored
+}
+
+static void queueMessage(uint8_t status, uint8_t data1, uint8_t data2) {
+  if (injectInput(status, data1, data2)) return;
+  
+  if (rxCount >= RX_QUEUE_SIZE) {
+    bridgeStats.droppedMessages++;
+    return;
+  }
+  rxQueue[rxHead] = {status, data1, data2, rxCable};
+  rxHead = (rxHead + 1) % RX_QUEUE_SIZE;
+  rxCount++;
+  bridgeStats.rxMessages++;
+}
+
+static int dataBytesFor(uint8_t status) {
+  uint8_t type = status & 0xF0;
+  return (type == 0xC0 || type == 0xD0) ? 1 : 2;
+}
+
+static void parseByte(uint8_t b) {
+  if (b >= 0xF8) return;  // Realtime, ignored
+  
+  if (b & 0x80) {
+    if (b == 0xF0) {
+      inSysex = true;
+      runningStatus = 0;  // Sysex cancels running status
+    } else if (b == 0xF7) {
+      inSysex = false;
+    } else if (b < 0xF0) {
+      runningStatus = b;
+      inSysex = false;
+    } else {
+      runningStatus = 0;  // System common, only the cable select is used
+    }
+    cableSelect = (b == NATIVE_CABLE_SELECT);
+    pendingCount = 0;
+    return;
+  }
+  
+  if (cableSelect) {
+    if (b < NATIVE_CABLES) rxCable = b;
+    cableSelect = false;
+    return;
+  }
+  if (inSysex || runningStatus == 0) return;
+  
+  pendingData[pendingCount++] = b;
+  if (pendingCount == dataBytesFor(runningStatus)) {
+    queueMessage(runningStatus, pendingData[0], pendingCount > 1 ? pendingData[1] : 0);
+    pendingCount = 0;
+  }
+}
+
+static unsigned long idleWaitUs = 500;
+
+void nativeBridgeSetIdleWait(unsigned long maxWaitUs) {
+  idleWaitUs = maxWaitUs;
+}
+
+void nativeBridgeIdle() {
+  nativeBridgeWait(idleWaitUs);
+}
+
+void nativeBridgeWait(unsigned long maxWaitUs) {
+  if (listenFd < 0) {
+    if (maxWaitUs) usleep(maxWaitUs);
+    return;
+  }
+  
+  struct pollfd fds[2];
+  int nfds = 0;
+  fds[nfds++] = {listenFd, POLLIN, 0};
+  if (clientFd >= 0) fds[nfds++] = {clientFd, POLLIN, 0};
+  
+  // Don't sleep while messages are still waiting for the firmware
+  int timeoutMs = (rxCount > 0 || maxWaitUs == 0) ? 0 : (int)((maxWaitUs + 999) / 1000);
+  if (poll(fds, nfds, timeoutMs) <= 0) return;
+  
+  if (fds[0].revents & POLLIN) {
+    acceptClient();
+  }
+  
+  if (nfds > 1 && clientFd >= 0 && (fds[1].revents & (POLLIN | POLLHUP | POLLERR))) {
+    uint8_t buffer[1024];
+    ssize_t n = recv(clientFd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (n <= 0) {
+      if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) closeClient();
+      return;
+    }
+    bridgeStats.rxBytes += (unsigned long)n;
+    for (ssize_t i = 0; i < n; i++) {
+      parseByte(buffer[i]);
+    }
+  }
+}
+
+// ================================
+// usbMIDI
+// ================================
+
+bool usb_midi_class::read(uint8_t channel) {
+  if (rxCount == 0) return false;
+  
+  NativeMidiMessage msg = rxQueue[rxTail];
+  rxTail = (rxTail + 1) % RX_QUEUE_SIZE;
+  rxCount--;
+  
+  msgType = msg.status & 0xF0;
+  msgChannel = (msg.status & 0x0F) + 1;
+  msgData1 = msg.data1;
+  msgData2 = msg.data2;
+  msgCable = msg.cable;
+  
+  // Note On with velocity 0 is reported as Note Off, like the Teensy core
+  if (msgType == NoteOn && msgData2 == 0) msgType = NoteOff;
+  
+  return channel == 0 || channel == msgChannel;
+}
+
+void usb_midi_class::send(uint8_t type, uint8_t data1, uint8_t data2, uint8_t channel, uint8_t cable) {
+  (void)cable;
+  if (clientFd < 0) return;
+  
+  if (txLength + 3 > sizeof(txBuffer)) send_now();
+  txBuffer[txLength++] = (uint8_t)((type & 0xF0) | ((channel - 1) & 0x0F));
+  txBuffer[txLength++] = data1 & 0x7F;
+  txBuffer[txLength++] = data2 & 0x7F;
+  bridgeStats.txMessages++;
+  
+  if (txLength >= TX_FLUSH_BYTES) send_now();
+}
+
+void usb_midi_class::sendNoteOn(uint8_t note, uint8_t velocity, uint8_t channel, uint8_t cable) {
+  send(NoteOn, note, velocity, channel, cable);
+}
+
+void usb_midi_class::sendNoteOff(uint8_t note, uint8_t velocity, uint8_t channel, uint8_t cable) {
+  send(NoteOff, note, velocity, channel, cable);
+}
+
+void usb_midi_class::sendControlChange(uint8_t control, uint8_t value, uint8_t channel, uint8_t cable) {
+  send(ControlChange, control, value, channel, cable);
+}
+
+void usb_midi_class::send_now() {
+  if (clientFd < 0 || txLength == 0) {
+    txLength = 0;
+    return;
+  }
+  
+  size_t offset = 0;
+  while (offset < txLength) {
+    ssize_t n = ::send(clientFd, txBuffer + offset, txLength - offset, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR || errno == EAGAIN) continue;
+      closeClient();
+      return;
+    }
+    offset += (size_t)n;
+  }
+  txLength = 0;
+}
@@ -0,0 +1,46 @@
+#ifndef NATIVE_BRIDGE_H
+#define NATIVE_BRIDGE_H
+
+#include <stdint.h>
+
+// ================================
+// NATIVE MIDI BRIDGE
+// ================================
+// Exposes the simulated usbMIDI on a UNIX domain socket speaking raw MIDI bytes, one client at a time
+// Everything the client sends reaches handleIncomingMIDI() through usbMIDI.read(), everything the
+// firmware sends (sendMidiEncoder(), buttons, credits) is written back to the client on send_now()
+//
+// Input injection uses MIDI channel 16, which the firmware never sees:
+//   CC ch16:       CC number = encoder index (0-12), value = 64 + detents (63 = one step left, 66 = two right)
+//   Note On ch16:  note = GPIO pin, velocity > 0 pulls the pin LOW (button pressed), velocity 0 releases
+//   Note Off ch16: note = GPIO pin, releases the button
+//
+// USB MIDI cables: 0xF5 n (the unofficial cable/port select) tags the messages that follow with cable n
+// (0-3, each connection starts on cable 0). What the firmware sends on every cable is merged on the socket.
+
+const uint8_t NATIVE_INJECT_CHANNEL = 16;
+const uint8_t NATIVE_CABLE_SELECT = 0xF5;
+const int NATIVE_CABLES = 4;
+
+struct NativeBridgeStats {
+  unsigned long clients;          // Connections accepted
+  unsigned long rxBytes;
+  unsigned long rxMessages;       // Messages queued for usbMIDI.read()
+  unsigned long txMessages;       // Messages written to the client
+  unsigned long injectedDetents;
+  unsigned long injectedButtons;
+  unsigned long droppedMessages;  // Receive queue full
+};
+
+bool nativeBridgeBegin(const char* socketPath);
+void nativeBridgeEnd();
+
+// Accept clients and read pending bytes, waiting up to maxWaitUs when nothing is queued
+void nativeBridgeWait(unsigned long maxWaitUs);
+// Low power idle stand-in for WFE: nativeBridgeWait() for the wait set with nativeBridgeSetIdleWait()
+void nativeBridgeSetIdleWait(unsigned long maxWaitUs);
+void nativeBridgeIdle();
+
+const NativeBridgeStats& nativeBridgeStats();
+
+#endif // NATIVE_BRIDGE_H
@@ -0,0 +1,36 @@
+#include "Arduino.h"
+#include "NativeBridge.h"
+
+// ================================
+// NATIVE ENTRY POINT
+// ================================
+// Runs the firmware's setup()/loop() on the host with usbMIDI bridged to a UNIX socket
+//   EVOCMDWING_SOCKET   socket path (default /tmp/evocmdwing.sock), or the first argument
+//   EVOCMDWING_IDLE_US  max wait of the firmware's idle step when no MIDI is queued (default 500, 0 = busy loop)
+
+void setup();
+void loop();
+
+int main(int argc, char** argv) {
+  const char* socketPath = getenv("EVOCMDWING_SOCKET");
+  if (argc > 1) socketPath = argv[1];
+  if (!socketPath) socketPath = "/tmp/evocmdwing.sock";
+  
+  const char* idleEnv = getenv("EVOCMDWING_IDLE_US");
+  unsigned long idleUs = idleEnv ? strtoul(idleEnv, nullptr, 10) : 500;
+  
+  if (!nativeBridgeBegin(socketPath)) {
+    return 1;
+  }
+  
+  nativeBridgeSetIdleWait(idleUs);
+  setup();
+  for (;;) {
+    // loop() waits in idleUntilWork() when it has nothing to do, only pick up new bytes here
+    loop();
+    nativeBridgeWait(0);
+  }
+  
+  nativeBridgeEnd();
+  return 0;
+}
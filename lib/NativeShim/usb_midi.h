@@ -0,0 +1,49 @@
+#ifndef NATIVE_USB_MIDI_H
+#define NATIVE_USB_MIDI_H
+
+#include <stdint.h>
+
+// ================================
+// NATIVE usbMIDI
+// ================================
+// Same interface as the Teensy core usbMIDI, backed by the UNIX socket bridge (NativeBridge.h)
+// Messages the firmware sends are buffered and written to the connected client on send_now()
+
+class usb_midi_class {
+public:
+  enum {
+    InvalidType = 0x00,
+    NoteOff = 0x80,
+    NoteOn = 0x90,
+    AfterTouchPoly = 0xA0,
+    ControlChange = 0xB0,
+    ProgramChange = 0xC0,
+    AfterTouchChannel = 0xD0,
+    PitchBend = 0xE0,
+    SystemExclusive = 0xF0
+  };
+
+  bool read(uint8_t channel = 0);
+  uint8_t getType() const { return msgType; }
+  uint8_t getChannel() const { return msgChannel; }
+  uint8_t getData1() const { return msgData1; }
+  uint8_t getData2() const { return msgData2; }
+  uint8_t getCable() const { return msgCable; }
+
+  void sendNoteOn(uint8_t note, uint8_t velocity, uint8_t channel, uint8_t cable = 0);
+  void sendNoteOff(uint8_t note, uint8_t velocity, uint8_t channel, uint8_t cable = 0);
+  void sendControlChange(uint8_t control, uint8_t value, uint8_t channel, uint8_t cable = 0);
+  void send(uint8_t type, uint8_t data1, uint8_t data2, uint8_t channel, uint8_t cable);
+  void send_now();
+
+private:
+  uint8_t msgType = 0;
+  uint8_t msgChannel = 0;
+  uint8_t msgData1 = 0;
+  uint8_t msgData2 = 0;
+  uint8_t msgCable = 0;
+};
+
+extern usb_midi_class usbMIDI;
+
+#endif // NATIVE_USB_MIDI_H
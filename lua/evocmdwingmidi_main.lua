@@ -14,19 +14,44 @@
 --     Track and send the fader values for Executors 291-298 for syncing encoder values for XKeys 1-8
 --     Track and send the status of Executors 191-198 and 291-298 (XKeys 1-16) Tracks: Populated/On/Off/Appearance Color
 --     Cache status data to reduce midi traffic on page changes and will send updates when assignments or appearance changes
+--     The executors and XKeys above are the default WINGS entry, more ranges or wings can be added there
+
+-- Wings:
+--     Every wing has its own MIDI channel block (channels below are for channelBase 0), remotes, link sequences,
+--         outgoing queue and page caches, the remote and link names of wings after the first carry a suffix
+--     Per cycle every monitored executor is read once, only the XKeys that differ from the wing's cached arrays are
+--         read again and sent, so the cycle cost grows with the number of executors, not with what is sent
 
 -- Midi Channels:
---     Channel 1: Fader sync: XKeys 1-8 use CC 6-13 (only on sequence changes/page changes) Manually chaning XKey Encoder values in software will cause Physical Encoders to be out of sync until page/sequence change
+--     Channel 1: Fader sync: XKeys 1-8 use CC 6-13 (page/sequence changes, and whenever the fader moves in software)
 --     Channel 2: Status: XKeys 1-16 use CC 1-16 (populated/on/off state)
 --     Channel 2: RGB: XKeys 1-16 use CC 17-64 (3 CCs each (rgb), only sent when populated and not black)
+--                A wing with N XKeys uses status CC 1-N and RGB CC N+1 to 4N
 --     Channel 3: Page changes: CC 1 = current page number (1-127)
+--                              CC 2 = write page (1-127), the channel 1/2 data that follows is for that page, 0 = current page
+--     Channel 4: Wing link: CC 1 = credit request, CC 2 = page digest request, CC 3 = ping (plugin → wing)
+--                           CC 1 = receive credits, CC 2 = grant number (wing → plugin, read back through the EvoLink remotes)
+--                           CC 3 = digest request number, CC 4-7 / 10-13 = page digests, low / high 7 bits (wing → plugin)
+--                           CC 8 = wing receive ring depth, CC 9 = ping answer (wing → plugin)
+
+-- Wing link:
+--     grandMA3 plugins can't read MIDI input, so Create MIDI Remotes also creates the EvoWingLink sequence and EvoLink remotes
+--     The remotes move the sequence faders with the wing's channel 4 CCs and the plugin reads the faders back
+--     On a page change the wing reports a digest per group of 4 XKeys of what its page cache holds,
+--         only groups that differ from the live executors are resent (EvoWingDigest and EvoWingDigestHigh, optional)
+--     Without the link the plugin falls back to sending one message every 10ms
+--     A ping every second measures the round trip to the wing, shown in debug mode (STATS on the wing's serial
+--         shows the same pings from its side: time spent in its receive ring and the ring depth)
 
 -- Status encoding:
 --     Status encoding: 0=not populated, 65=populated+off, 127=populated+on
 --     RGB: 0-127 per rgb channel, black sequences sent as white (127,127,127) for visibility
 --         You can change the default color variables to replace black appearances
 --     Page tracking: Caches state for pages, only sends changes
---     Fader sync: Only sends fader values when sequence assignments change (prevents encoder jumping)
+--     Page prefetch: Neighbouring and recently used pages are indexed in the background (a few executors per cycle,
+--         after the current page's changes are sent) and written to the wing's page cache, so page changes show at once
+--     Fader sync: Sends fader values on page/sequence changes and tracks fader moves every cycle (deadband + rate limit)
+--         The wing holds feedback while its encoder is being turned, so tracking doesn't fight the operator
 
 -- XKey RGB
 --     You can change the defualt color of newly created XKeys below, it replaces black (can be black for default LEDs off)
@@ -41,38 +66,134 @@ local rate = 0.1         --100ms
 -- Starting CC for MIDI feedback
 local startingCC = 6
 -- local endingCC = startingCC + 7  -- CC 6-13 for XKeys 1-8
+-- Channels of a wing with channelBase 0, other wings add their base
 local midiChannel = 1
 local statusMidiChannel = 2
 local pageMidiChannel = 3
+local linkMidiChannel = 4
 
 -- Default color for black (0,0,0) sequences - for visibility
 local defaultRed = 255
 local defaultGreen = 255
 local defaultBlue = 255
 
+-- Wings and the executor ranges they show, XKeys are numbered in range order (XKey 1 = first executor of the first range)
+--     channelBase: MIDI channel offset, the wing uses channels base+1 to base+4 (set the wing's firmware to the same base: CONFIG SET midiChannelBase, default 0)
+--     ranges: first/last executor, encoders = true for XKeys with an absolute encoder (fader sync on CC 6 up, XKeyRotate/XKeyPress remotes)
+--     suffix: added to the wing's remote and link sequence names, wings after the first default to "_<n>"
+-- Status CC 1-N and RGB CC N+1 to 4N limit a wing to 31 XKeys, larger sets are split over several wings
+-- A global EvoCmdWingWings table (set by another plugin, or the offline runner's show) replaces this one
+local WINGS = EvoCmdWingWings or {
+    {
+        name = "EvoCmdWing",
+        channelBase = 0,
+        ranges = {
+            {first = 291, last = 298, encoders = true}, -- XKeys 1-8
+            {first = 191, last = 198},                  -- XKeys 9-16
+        },
+    },
+}
+local maxWingKeys = 31
+local wings = {} -- Per wing executor maps and state, built from WINGS by buildWings()
+
 local running = false
 local debugMode = false -- Debug output mode - off by default
 local currentPage = nil -- Track current page
-
--- Page-based state tracking for up to 127 pages
-local pageIndex = {} -- Track which pages we've indexed: pageIndex[pageNum] = true
-local pageExecutorStates = {} -- [pageNum][execNum] = {populated, on, colorR, colorG, colorB}
 local startupComplete = false -- Track if we've done initial indexing
 
--- Change tracking for exeecutors
-local changedExecutors = {} -- List of executors that changed on current page
-
--- MIDI Remote caching
-local cachedXKeyRemotes = {} -- Cache of found XKey remotes: {remote_object, exec_info}
-local remoteCacheComplete = false -- Track if we've cached all remotes
-local expectedRemoteCount = 16 -- XKeyRotate1-8 + XKeyPress1-8
-
--- All Executors (Xkeys) to monitor
-local EXECUTORS_TO_MONITOR = {191,192,193,194,195,196,197,198,291,292,293,294,295,296,297,298}
+-- MIDI remote retargeting, only done when the page or an XKey executor's assigned object changes
+local remoteStats = {cycles = 0, retargetCycles = 0, remotesVisited = 0, remoteWrites = 0}
+local remoteStatsReportCycles = 600 -- Debug summary interval (~60s)
 
 -- Current page
 local currentCyclePageNum = nil
 
+-- Wing link, firmware → plugin values arrive as fader positions of the link sequence
+local LINK_SEQUENCE_NAMES = {"EvoWingLink", "EvoWingDigest", "EvoWingDigestHigh"}
+local LINK_SLOTS = {
+    credits = {name = "EvoLinkCredits", cc = 1, seq = 1, fader = "Master", token = "FaderMaster"},
+    grant   = {name = "EvoLinkGrant",   cc = 2, seq = 1, fader = "X",      token = "FaderX"},
+    pongDepth = {name = "EvoLinkPongDepth", cc = 8, seq = 1, fader = "XA", token = "FaderXA"},
+    pong      = {name = "EvoLinkPong",      cc = 9, seq = 1, fader = "XB", token = "FaderXB"},
+    digestNumber = {name = "EvoLinkDigestNumber", cc = 3, seq = 2, fader = "Temp",   token = "FaderTemp"},
+    digest1      = {name = "EvoLinkDigest1",      cc = 4, seq = 2, fader = "Master", token = "FaderMaster"},
+    digest2      = {name = "EvoLinkDigest2",      cc = 5, seq = 2, fader = "X",      token = "FaderX"},
+    digest3      = {name = "EvoLinkDigest3",      cc = 6, seq = 2, fader = "XA",     token = "FaderXA"},
+    digest4      = {name = "EvoLinkDigest4",      cc = 7, seq = 2, fader = "XB",     token = "FaderXB"},
+    digestHigh1  = {name = "EvoLinkDigestHigh1",  cc = 10, seq = 3, fader = "Master", token = "FaderMaster"},
+    digestHigh2  = {name = "EvoLinkDigestHigh2",  cc = 11, seq = 3, fader = "X",      token = "FaderX"},
+    digestHigh3  = {name = "EvoLinkDigestHigh3",  cc = 12, seq = 3, fader = "XA",     token = "FaderXA"},
+    digestHigh4  = {name = "EvoLinkDigestHigh4",  cc = 13, seq = 3, fader = "XB",     token = "FaderXB"},
+}
+
+-- Page digests, one per group of XKeys (XKeys 1-4, 5-8, 9-12, 13-16 on a 16 XKey wing), 14 bits over two CCs
+local DIGEST_SLOTS = {LINK_SLOTS.digest1, LINK_SLOTS.digest2, LINK_SLOTS.digest3, LINK_SLOTS.digest4}
+local DIGEST_HIGH_SLOTS = {LINK_SLOTS.digestHigh1, LINK_SLOTS.digestHigh2, LINK_SLOTS.digestHigh3, LINK_SLOTS.digestHigh4}
+local digestWaitPolls = 25 -- Polls (~50ms) to wait for the wing's answer before resending the page the old way
+local digestStats = {pages = 0, groupsMatched = 0, groupsResent = 0, timeouts = 0}
+
+-- Round trip pings, the wing answers from its MIDI input handler with its receive ring depth
+local pingInterval = 10 -- Cycles (~1s) between pings, 0 = off
+local pingTimeout = 0.050 -- Seconds to wait for the answer
+local pingGiveUp = 5 -- Unanswered pings in a row before pinging stops (EvoLink ping remotes missing)
+local pingReportCycles = 100 -- Debug summary interval (~10s)
+local pingSampleCount = 64 -- Round trips kept for the summary
+local wallClock = Time or os.clock -- grandMA3 Time() is wall clock seconds, os.clock() only counts CPU time
+
+-- Outgoing MIDI queue (one per wing), status/page/fader messages are sent ahead of color refreshes, prefetched pages last
+local MIDI_PRIORITY_STATUS = 1
+local MIDI_PRIORITY_COLOR = 2
+local MIDI_PRIORITY_PREFETCH = 3
+
+-- Credit based pacing, sends bursts as large as the wing's free receive slots
+local creditPollInterval = 0.002 -- Seconds between link reads while waiting for credits
+local creditRequestPolls = 25 -- Polls (~50ms) before asking the wing again
+local creditGiveUpRequests = 4 -- Unanswered requests before falling back to fixed pacing for this flush
+local fallbackInterval = 0.010 -- One message per 10ms when the link isn't available
+
+-- Continuous fader tracking for the XKeys with encoders (executors 291-298, XKeys 1-8 by default)
+local faderDeadband = 1 -- MIDI steps a fader has to move before it's sent
+local faderSyncCycles = 2 -- Minimum cycles between sends for the same executor (rate limit)
+local cycleCount = 0
+
+-- Background page prefetch, runs after the cycle's own MIDI is flushed and stops at the budget
+local prefetchNeighbours = 2 -- Pages either side of the current page
+local prefetchRecentPages = 4 -- Recently used pages kept up to date
+local prefetchBudget = 0.002 -- Seconds of executor reads per cycle
+local prefetchMaxExecutors = 8 -- Executors read per cycle at most
+local prefetchRescanCycles = 50 -- Cycles (~5s) between passes over the same pages
+local prefetchList = {} -- Pages left in this pass, next first
+local prefetchWing = 1 -- Wing being prefetched on prefetchList[1]
+local prefetchPos = 1 -- Next XKey of that wing
+local prefetchNextPass = 0 -- cycleCount the next pass starts at
+local recentPages = {} -- Most recently left page first
+local prefetchStats = {pages = 0, executors = 0, messages = 0}
+
+-- Cmd() batching, each Cmd() is a full command line parse so queued SendMIDI commands are joined with ';'
+local maxCommandsPerCmd = 16 -- SendMIDI commands per Cmd() call
+local cmdBatch = {} -- Reused scratch list for building a batch
+local cmdStats = {calls = 0, messages = 0, seconds = 0, maxSeconds = 0} -- Per cycle, reset by reportCycleStats()
+
+-- GetFader arguments, shared so the per cycle reads don't build a table each
+local FADER_MASTER = {token = "FaderMaster", faderDisabled = false}
+for _, slot in pairs(LINK_SLOTS) do
+    slot.faderArgs = {token = slot.token}
+end
+
+-- Steady state allocation: page caches are bounded and recycled, SendMIDI commands and ObjectList queries are built once
+local maxCachedPages = 16 -- Page caches kept per wing, the least recently used page is dropped (and synced again on its next visit)
+local midiCommands = {} -- [(channel * 128 + cc) * 128 + value] = SendMIDI command
+local executorQueries = {} -- [pageNum * 1000 + execNum] = ObjectList query
+local snapshot = {populated = {}, on = {}, r = {}, g = {}, b = {}, fader = {}} -- Scratch executor state by key (page digests)
+local wingDigests = {} -- Scratch, digests read back from the wing
+local pingSorted = {} -- Scratch, round trips sorted for the summary
+local prefetchListed = {} -- Scratch, pages already on prefetchList
+local remoteScanList = {} -- Scratch, wings whose remotes are being scanned
+
+-- Lua memory, shown in debug mode: heap size, KB allocated inside plugin cycles and completed GC cycles per minute
+local memStatsReportCycles = 600 -- Debug summary interval (~60s)
+local memStats = {cycles = 0, allocatedKB = 0, gcCycles = 0, reportClock = nil, reportGcCycles = 0}
+
 -- Debug print function - only prints if debug mode is enabled
 local function DebugPrint(...)
     if debugMode then
@@ -81,247 +202,667 @@ local function DebugPrint(...)
 end
 
 
+-- WINGS --
+
+-- Executor maps and empty state for one WINGS entry
+-- Everything per XKey is kept in arrays indexed by the XKey number (key), the same on every page
+local function newWing(index, spec)
+    local base = spec.channelBase or 0
+    local suffix = spec.suffix or (index == 1 and "" or "_" .. index)
+    local escaped = suffix:gsub("%W", "%%%0")
+    local wing = {
+        index = index,
+        name = spec.name or ("Wing " .. index),
+        ranges = spec.ranges or {},
+        suffix = suffix,
+        faderChannel = base + midiChannel,
+        statusChannel = base + statusMidiChannel,
+        pageChannel = base + pageMidiChannel,
+        linkChannel = base + linkMidiChannel,
+        rotatePattern = "^[Xx][Kk]ey[Rr]otate(%d+)" .. escaped .. "$",
+        pressPattern = "^[Xx][Kk]ey[Pp]ress(%d+)" .. escaped .. "$",
+
+        execs = {},             -- [key] = executor number
+        encoderOf = {},         -- [key] = encoder number (fader CC startingCC + n - 1), false without an encoder
+        encoderKeys = {},       -- [encoder] = key
+        keyCount = 0,
+        groupKeys = 0,          -- XKeys per page digest group, like the firmware's PAGE_DIGEST_KEYS
+
+        -- What the wing was sent, [pageNum] = {populated = {}, on = {}, r = {}, g = {}, b = {}, fader = {}} by key (see pageCache())
+        pages = {},
+        pageCount = 0,
+        pageUsed = {},          -- [pageNum] = cycleCount the page cache was last used
+        pageIndex = {},         -- [pageNum] = true once the wing has had the whole page
+        changed = {},           -- Keys that changed this cycle, the first changedCount entries (reused)
+        changedCount = 0,
+
+        -- Fader tracking for the XKeys with encoders
+        lastFaderSent = {},     -- [key] = last MIDI value sent (0-127)
+        lastFaderSentCycle = {},-- [key] = cycle number of the last send
+
+        -- Outgoing queue and wing link
+        queues = {{}, {}, {}},  -- [priority] = SendMIDI commands waiting to be sent
+        queueHeads = {1, 1, 1}, -- [priority] = index of next command to send
+        queuedCount = 0,
+        linkSequences = nil,    -- Link sequence objects, false when the link isn't set up
+        creditRequest = 0,      -- Outstanding credit request number (1-127), 0 when none is outstanding
+        digestRequest = 0,      -- Last digest request number (1-127)
+        prefetchFramePage = nil,
+        pingId = 0,             -- Last ping ID (1-127)
+        pingMissed = 0,         -- Unanswered pings in a row
+        pingSamples = {},       -- Ring of the last round trips, seconds
+        pingStats = {sent = 0, answered = 0, timeouts = 0, cmdSeconds = 0, lastDepth = 0, maxDepth = 0, nextSample = 1},
+
+        -- MIDI remote caching and retargeting
+        cachedRemotes = {},     -- {remote =, exec =, name =}
+        remoteCacheComplete = false,
+        remoteTargetPage = nil, -- Page the remotes were last targeted for
+        remoteTargetObjects = {}, -- [key] = object the remotes were last targeted at
+        retargetKeys = {},      -- [key] = true when its remotes need retargeting this cycle (reused)
+        faderRefs = {},         -- [key] = fader looked up during a retarget, false for none (reused)
+    }
+
+    for _, range in ipairs(wing.ranges) do
+        for execNum = range.first, range.last do
+            local key = wing.keyCount + 1
+            wing.keyCount = key
+            wing.execs[key] = execNum
+            if range.encoders then
+                local encoder = #wing.encoderKeys + 1
+                wing.encoderKeys[encoder] = key
+                wing.encoderOf[key] = encoder
+            else
+                wing.encoderOf[key] = false
+            end
+        end
+    end
+    wing.groupKeys = math.ceil(wing.keyCount / #DIGEST_SLOTS)
+    return wing
+end
+
+local function buildWings()
+    wings = {}
+    for index, spec in ipairs(WINGS) do
+        local wing = newWing(index, spec)
+        if wing.keyCount == 0 or wing.keyCount > maxWingKeys or wing.linkChannel > 16 then
+            Printf("Wing '%s' skipped: %d XKeys on MIDI channels %d-%d (1-%d XKeys, channels up to 16)",
+                   wing.name, wing.keyCount, wing.faderChannel, wing.linkChannel, maxWingKeys)
+        else
+            wings[#wings + 1] = wing
+        end
+    end
+end
+
+-- Drop the least recently used page cache (never the current page) and return its arrays, cleared, for reuse
+local function evictPageCache(wing)
+    local oldest, oldestUsed = nil, nil
+    for pageNum, used in pairs(wing.pageUsed) do
+        if pageNum ~= currentCyclePageNum and (not oldestUsed or used < oldestUsed) then
+            oldest, oldestUsed = pageNum, used
+        end
+    end
+    if not oldest then
+        return nil
+    end
+
+    local cache = wing.pages[oldest]
+    for key = 1, wing.keyCount do
+        cache.populated[key], cache.on[key], cache.r[key], cache.g[key], cache.b[key], cache.fader[key] = nil
+    end
+    wing.pages[oldest] = nil
+    wing.pageUsed[oldest] = nil
+    wing.pageIndex[oldest] = nil -- Synced again (digests or in full) on the next visit
+    wing.pageCount = wing.pageCount - 1
+    DebugPrint("Page %d cache dropped (%s)", oldest, wing.name)
+    return cache
+end
+
+-- Cached state of one page on one wing, parallel arrays by key, nil = unknown (always differs)
+-- fader holds the fader values the wing has for the page while it isn't current (the current page is tracked live)
+local function pageCache(wing, pageNum)
+    local cache = wing.pages[pageNum]
+    if not cache then
+        if wing.pageCount >= maxCachedPages then
+            cache = evictPageCache(wing)
+        end
+        cache = cache or {populated = {}, on = {}, r = {}, g = {}, b = {}, fader = {}}
+        wing.pages[pageNum] = cache
+        wing.pageCount = wing.pageCount + 1
+    end
+    wing.pageUsed[pageNum] = cycleCount
+    return cache
+end
+
+local function setCachedExecutorState(cache, key, populated, on, colorR, colorG, colorB)
+    cache.populated[key] = populated
+    cache.on[key] = on
+    cache.r[key] = colorR
+    cache.g[key] = colorG
+    cache.b[key] = colorB
+end
+
+
+local function clearList(list)
+    for i = #list, 1, -1 do
+        list[i] = nil
+    end
+end
+
 -- Clear all cached state variables (called on script startup)
 local function clearAllCachedState()
     currentPage = nil
-    pageIndex = {}
-    pageExecutorStates = {}
     startupComplete = false
-    changedExecutors = {}
-    
-    -- Clear MIDI remote cache
-    cachedXKeyRemotes = {}
-    remoteCacheComplete = false
-    
+
+    -- Fresh executor maps, page caches, queues, link and remote state for every wing
+    buildWings()
+    remoteStats = {cycles = 0, retargetCycles = 0, remotesVisited = 0, remoteWrites = 0}
+
     -- Clear page cache
     currentCyclePageNum = nil
-    
+
+    digestStats = {pages = 0, groupsMatched = 0, groupsResent = 0, timeouts = 0}
+    cycleCount = 0
+    memStats.cycles = 0
+    memStats.allocatedKB = 0
+    memStats.reportClock = nil
+
+    -- Clear prefetch state
+    clearList(prefetchList)
+    prefetchWing = 1
+    prefetchPos = 1
+    prefetchNextPass = 0
+    clearList(recentPages)
+    prefetchStats = {pages = 0, executors = 0, messages = 0}
+
     DebugPrint("Cached state cleared - ready for direct access sync")
 end
 
 
-local function getDirectExecutorInfo(execNum)
-    -- Get executor status
-    local exec, page = GetExecutor(execNum)
-    
+-- ObjectList query for an executor of any page, built once per page and executor
+local function executorQuery(pageNum, execNum)
+    local id = pageNum * 1000 + execNum
+    local query = executorQueries[id]
+    if not query then
+        query = "page " .. pageNum .. "." .. execNum
+        executorQueries[id] = query
+    end
+    return query
+end
+
+-- Fader reference for MIDI remote assignment (ObjectList lookup, keep out of per-cycle paths)
+local function getExecutorFaderRef(execNum)
+    local objectListExec = ObjectList(executorQuery(currentCyclePageNum, execNum))[1]
+    if objectListExec then
+        return objectListExec.fader
+    end
+    return nil
+end
+
+-- Status and color of an executor handle (GetExecutor on the current page, ObjectList for other pages)
+-- Returns populated, on, r, g, b (0-255), object, no tables are built
+local function readExecutorState(exec)
     if not exec then
         -- Executor doesn't exist
-        return {
-            faderValue = 0,
-            isOn = false,
-            isPopulated = false,
-            color = {r = 0, g = 0, b = 0},
-            object = nil,
-            faderRef = nil
-        }
-    end
-    
-    -- Get all live values directly from the executor
-    local faderValue = exec:GetFader{token = "FaderMaster", faderDisabled = false} or 0
+        return false, false, 0, 0, 0, nil
+    end
+
     local myObject = exec.Object
-    local isPopulated = (myObject ~= nil)
-    local isOn = isPopulated and myObject:HasActivePlayback() or false
-    
+    if myObject == nil then
+        return false, false, 0, 0, 0, nil
+    end
+    local isOn = myObject:HasActivePlayback() or false
+
     -- Get color data
-    local color = {r = 0, g = 0, b = 0}
-    if isPopulated then
-        local apper = myObject["APPEARANCE"]
-        if apper then
-            color = {
-                r = apper['BACKR'] or 0,
-                g = apper['BACKG'] or 0,
-                b = apper['BACKB'] or 0
-            }
-        end
-    end
-    
-    -- Get fader reference for MIDI remote assignment
-    local faderRef = nil
-    local objectListExec = ObjectList("page " .. currentCyclePageNum .. "." .. execNum)[1]
-    if objectListExec then
-        faderRef = objectListExec.fader
-    end
-    
-    return {
-        faderValue = faderValue,
-        isOn = isOn,
-        isPopulated = isPopulated,
-        color = color,
-        object = myObject,
-        faderRef = faderRef
-    }
+    local apper = myObject["APPEARANCE"]
+    if apper then
+        return true, isOn, apper['BACKR'] or 0, apper['BACKG'] or 0, apper['BACKB'] or 0, myObject
+    end
+    return true, isOn, 0, 0, 0, myObject
+end
+
+-- Fader value only, much cheaper than a status read (no Object lookup)
+local function getExecutorFader(exec)
+    if not exec then
+        return 0
+    end
+    return exec:GetFader(FADER_MASTER) or 0
 end
 
 
-local function getXKeyMapping(remoteName)
-    -- Handle both XKeyRotate and XKeyPress remotes
-    local rotateNum = remoteName:match("^[Xx][Kk]ey[Rr]otate(%d+)$")
-    local pressNum = remoteName:match("^[Xx][Kk]ey[Pp]ress(%d+)$")
-    
-    local executorNumber = nil
-    local remoteType = nil
-    
-    local keyNum = nil
-    if rotateNum then
-        keyNum = tonumber(rotateNum)
-        executorNumber = 290 + keyNum -- XKeyRotate1 = 291, etc.
-        remoteType = "Fader"
-    elseif pressNum then
-        keyNum = tonumber(pressNum)
-        executorNumber = 290 + keyNum -- XKeyPress1 = 291, etc.
-        remoteType = "Key"
+-- WING LINK --
+
+local function findSequenceByName(name)
+    for _, seq in pairs(DataPool().Sequences:Children()) do
+        if seq.name == name then
+            return seq
+        end
     end
-    
-    if executorNumber and (executorNumber >= 291 and executorNumber <= 298) then
-        return {
-            page = currentCyclePageNum,
-            id = executorNumber,
-            type = remoteType,
-            xkeyNum = keyNum
-        }
-    else
-        return nil
+    return nil
+end
+
+-- Find the link sequences created by Create MIDI Remotes, the digest sequence is optional (older setups)
+local function resolveWingLink(wing)
+    local seqs = {}
+    for i, name in ipairs(LINK_SEQUENCE_NAMES) do
+        seqs[i] = findSequenceByName(name .. wing.suffix)
+    end
+    if not seqs[1] then
+        Printf("Wing link sequence '%s' not found - using fixed MIDI pacing (Create MIDI Remotes to enable)",
+               LINK_SEQUENCE_NAMES[1] .. wing.suffix)
+        wing.linkSequences = false
+        return
     end
+    for i = 2, 3 do
+        if not seqs[i] then
+            Printf("Wing link sequence '%s' not found - known pages are resynced in full (Create MIDI Remotes to enable)",
+                   LINK_SEQUENCE_NAMES[i] .. wing.suffix)
+        end
+    end
+    wing.linkSequences = seqs
+    DebugPrint("Wing link found for %s: %d sequence(s)", wing.name, #seqs)
 end
 
+-- Read a wing link value (0-127) back from its fader
+local function readLinkValue(wing, slot)
+    local seq = wing.linkSequences and wing.linkSequences[slot.seq]
+    if not seq then
+        return nil
+    end
+    local faderValue = seq:GetFader(slot.faderArgs)
+    if not faderValue then
+        return nil
+    end
+    return math.floor(faderValue * 127 / 100 + 0.5)
+end
 
-local function sendMidiFeedback(ccNumber, value)
-    local midiValue = math.floor((value / 100) * 127)
-    local command = 'SendMIDI "Control" ' .. midiChannel .. '/' .. ccNumber .. ' ' .. midiValue
+-- All MIDI goes through here so time spent in Cmd() is measured
+local function runCmd(command, messageCount)
+    local start = os.clock()
     Cmd(command)
-    
-    coroutine.yield(0.010) -- 10ms delay between midi sends  to not overwhelm teensy buffer
+    local elapsed = os.clock() - start
+    cmdStats.calls = cmdStats.calls + 1
+    cmdStats.messages = cmdStats.messages + messageCount
+    cmdStats.seconds = cmdStats.seconds + elapsed
+    if elapsed > cmdStats.maxSeconds then
+        cmdStats.maxSeconds = elapsed
+    end
+end
+
+-- SendMIDI command for a control change, each one is built the first time it's sent and reused after
+local function midiCommand(channel, ccNumber, midiValue)
+    local id = (channel * 128 + ccNumber) * 128 + midiValue
+    local command = midiCommands[id]
+    if not command then
+        command = 'SendMIDI "Control" ' .. channel .. '/' .. ccNumber .. ' ' .. midiValue
+        midiCommands[id] = command
+    end
+    return command
+end
+
+-- Credit request with a new request number, the wing echoes it as the grant of its answer
+local function creditRequestCommand(wing)
+    wing.creditRequest = wing.creditRequest % 127 + 1
+    return midiCommand(wing.linkChannel, LINK_SLOTS.credits.cc, wing.creditRequest)
+end
+
+local function requestWingCredits(wing)
+    runCmd(creditRequestCommand(wing), 1)
+end
+
+
+-- OUTGOING MIDI QUEUE --
+
+local function queueMidi(wing, priority, channel, ccNumber, midiValue)
+    local queue = wing.queues[priority]
+    queue[#queue + 1] = midiCommand(channel, ccNumber, midiValue)
+    wing.queuedCount = wing.queuedCount + 1
 end
 
+-- Next command to send, highest priority first
+local function popMidi(wing)
+    local queues, heads = wing.queues, wing.queueHeads
+    for priority = 1, #queues do
+        local queue = queues[priority]
+        local head = heads[priority]
+        local command = queue[head]
+        if command then
+            queue[head] = nil
+            heads[priority] = head + 1
+            wing.queuedCount = wing.queuedCount - 1
+            return command
+        end
+        -- Drained, start over at the front
+        heads[priority] = 1
+    end
+    return nil
+end
 
-local function sendMidiStatus(channel, ccNumber, value)
+-- Send up to count queued messages, joined into as few Cmd() calls as possible
+-- withCreditRequest appends a credit request to the last batch when messages are still queued
+local function sendMidiBurst(wing, count, withCreditRequest)
+    local sent = 0
+    local batched = 0
+    while sent < count do
+        local command = popMidi(wing)
+        if not command then
+            break
+        end
+        batched = batched + 1
+        cmdBatch[batched] = command
+        sent = sent + 1
+        if batched == maxCommandsPerCmd then
+            runCmd(table.concat(cmdBatch, "; ", 1, batched), batched)
+            batched = 0
+        end
+    end
+
+    local requested = withCreditRequest and wing.queuedCount > 0
+    if requested then
+        batched = batched + 1
+        cmdBatch[batched] = creditRequestCommand(wing)
+    end
+    if batched > 0 then
+        runCmd(table.concat(cmdBatch, "; ", 1, batched), batched)
+    end
+    return sent, requested
+end
+
+-- Per cycle Cmd() cost, shown in debug mode
+local function reportCycleStats()
+    if cmdStats.calls > 0 then
+        DebugPrint("Cycle MIDI: %d messages in %d Cmd() calls, %.2fms in Cmd() (max %.2fms)",
+               cmdStats.messages, cmdStats.calls, cmdStats.seconds * 1000, cmdStats.maxSeconds * 1000)
+    end
+    cmdStats.calls = 0
+    cmdStats.messages = 0
+    cmdStats.seconds = 0
+    cmdStats.maxSeconds = 0
+end
+
+-- Completed GC cycles are counted by a table that is collected once per cycle and arms the next one from its finalizer
+-- (needs Lua 5.2 or later, the count stays 0 otherwise)
+local gcSentinel = {}
+local function armGcSentinel()
+    if not memStats.sentinelArmed then
+        memStats.sentinelArmed = true
+        setmetatable({}, gcSentinel)
+    end
+end
+gcSentinel.__gc = function()
+    memStats.gcCycles = memStats.gcCycles + 1
+    memStats.sentinelArmed = false
+    if running then
+        armGcSentinel()
+    end
+end
+
+-- Heap growth over one cycle, summed and shown in debug mode every memStatsReportCycles cycles
+-- A GC step inside the cycle hides what it frees, so allocation shows up as a lower bound (0 in steady state)
+local function reportMemoryStats(cycleStartKB)
+    local inUse = collectgarbage("count")
+    if inUse > cycleStartKB then
+        memStats.allocatedKB = memStats.allocatedKB + (inUse - cycleStartKB)
+    end
+    memStats.cycles = memStats.cycles + 1
+
+    local now = wallClock()
+    if not memStats.reportClock then
+        memStats.reportClock = now
+        memStats.reportGcCycles = memStats.gcCycles
+    end
+    if memStats.cycles % memStatsReportCycles == 0 then
+        local minutes = (now - memStats.reportClock) / 60
+        if minutes > 0 then
+            DebugPrint("Lua memory: %.0f KB in use | %.2f KB allocated per minute in plugin cycles (%.3f KB per cycle) | %.1f GC cycles per minute",
+                   inUse, memStats.allocatedKB / minutes, memStats.allocatedKB / memStatsReportCycles,
+                   (memStats.gcCycles - memStats.reportGcCycles) / minutes)
+        end
+        memStats.allocatedKB = 0
+        memStats.reportClock = now
+        memStats.reportGcCycles = memStats.gcCycles
+    end
+end
+
+-- Send everything queued for a wing, in bursts as large as its receive credits allow
+-- Each burst ends with a credit request, the wing answers once it has processed the burst
+local function flushMidiQueue(wing)
+    if wing.queuedCount == 0 then
+        return
+    end
+
+    if wing.linkSequences == nil then
+        resolveWingLink(wing)
+    end
+
+    local sent, bursts, waits = 0, 0, 0
+    local polls, unanswered = 0, 0
+    local waiting = false
+
+    while wing.queuedCount > 0 do
+        local linkUsable = wing.linkSequences and unanswered <= creditGiveUpRequests
+
+        if linkUsable then
+            local credits = 0
+            local grant = readLinkValue(wing, LINK_SLOTS.grant)
+            -- Only the answer to the outstanding request counts, the keepalive (grant 0) or a late
+            -- answer to an earlier request would advertise slots the last burst is about to fill
+            if grant and wing.creditRequest ~= 0 and grant == wing.creditRequest then
+                wing.creditRequest = 0
+                credits = readLinkValue(wing, LINK_SLOTS.credits) or 0
+                waiting, polls, unanswered = false, 0, 0
+            elseif not waiting or polls >= creditRequestPolls then
+                requestWingCredits(wing)
+                waiting, polls = true, 0
+                unanswered = unanswered + 1
+            end
+
+            if credits > 1 then
+                -- Keep one credit for the request that closes the burst
+                local burstSent, requested = sendMidiBurst(wing, credits - 1, true)
+                sent = sent + burstSent
+                bursts = bursts + 1
+                if requested then
+                    waiting, polls = true, 0
+                end
+            end
+
+            if wing.queuedCount > 0 then
+                waits = waits + 1
+                polls = polls + 1
+                coroutine.yield(creditPollInterval)
+            end
+        else
+            if unanswered == creditGiveUpRequests + 1 then
+                DebugPrint("%s link not answering - fixed MIDI pacing for this flush", wing.name)
+                unanswered = unanswered + 1
+            end
+            sent = sent + sendMidiBurst(wing, 1, false)
+            bursts = bursts + 1
+            coroutine.yield(fallbackInterval)
+        end
+    end
+
+    DebugPrint("MIDI flush (%s): %d messages in %d bursts (%d credit waits)", wing.name, sent, bursts, waits)
+end
+
+local function flushAllWings()
+    for _, wing in ipairs(wings) do
+        flushMidiQueue(wing)
+    end
+end
+
+
+-- WING PING --
+
+-- Round trip summary: plugin side send cost (Cmd), round trip percentiles, wing ring depth
+local function reportPingStats(wing)
+    local stats = wing.pingStats
+    local sorted = pingSorted
+    clearList(sorted)
+    for i, rtt in ipairs(wing.pingSamples) do
+        sorted[i] = rtt
+    end
+    table.sort(sorted)
+    local n = #sorted
+    if n == 0 then
+        DebugPrint("%s ping: %d sent, no answers", wing.name, stats.sent)
+        return
+    end
+    DebugPrint("%s ping: %d sent, %d answered, %d timeouts | RTT ms min %.1f median %.1f p95 %.1f max %.1f (last %d) | Cmd() avg %.2fms | Wing ring depth last %d max %d",
+           wing.name, stats.sent, stats.answered, stats.timeouts,
+           sorted[1] * 1000, sorted[math.floor((n + 1) / 2)] * 1000, sorted[math.max(1, math.floor(n * 0.95))] * 1000,
+           sorted[n] * 1000, n, stats.cmdSeconds / stats.sent * 1000, stats.lastDepth, stats.maxDepth)
+end
+
+-- Ping the wing every pingInterval cycles and wait for the answer (polled like the credits)
+local function pingWing(wing)
+    if pingInterval == 0 or wing.pingMissed >= pingGiveUp or not wing.linkSequences or cycleCount % pingInterval ~= 0 then
+        return
+    end
+    local stats = wing.pingStats
+    if wing.pingId == 0 then
+        -- Continue after whatever the fader holds from an earlier run, so an old answer never matches
+        wing.pingId = readLinkValue(wing, LINK_SLOTS.pong) or 0
+    end
+    wing.pingId = wing.pingId % 127 + 1
+
+    local start = wallClock()
+    runCmd(midiCommand(wing.linkChannel, 3, wing.pingId), 1)
+    stats.cmdSeconds = stats.cmdSeconds + (wallClock() - start)
+    stats.sent = stats.sent + 1
+
+    repeat
+        coroutine.yield(creditPollInterval)
+        if readLinkValue(wing, LINK_SLOTS.pong) == wing.pingId then
+            local rtt = wallClock() - start
+            local depth = readLinkValue(wing, LINK_SLOTS.pongDepth) or 0
+            wing.pingSamples[stats.nextSample] = rtt
+            stats.nextSample = stats.nextSample % pingSampleCount + 1
+            stats.answered = stats.answered + 1
+            stats.lastDepth = depth
+            stats.maxDepth = math.max(stats.maxDepth, depth)
+            wing.pingMissed = 0
+            if cycleCount % pingReportCycles == 0 then
+                reportPingStats(wing)
+            end
+            return
+        end
+    until wallClock() - start >= pingTimeout
+
+    stats.timeouts = stats.timeouts + 1
+    wing.pingMissed = wing.pingMissed + 1
+    if wing.pingMissed == pingGiveUp then
+        Printf("%s isn't answering pings - round trip measurement off (Create MIDI Remotes to enable)", wing.name)
+    end
+end
+
+
+-- Fader percent (0-100) to MIDI (0-127), rounded so encoder values survive the round trip through the fader
+local function faderToMidi(value)
+    local midiValue = math.floor((value / 100) * 127 + 0.5)
+    return midiValue > 127 and 127 or (midiValue < 0 and 0 or midiValue)
+end
+
+local function sendMidiFeedback(wing, ccNumber, value)
+    queueMidi(wing, MIDI_PRIORITY_STATUS, wing.faderChannel, ccNumber, faderToMidi(value))
+end
+
+
+local function sendMidiStatus(wing, channel, ccNumber, value)
     local midiValue = value > 127 and 127 or (value < 0 and 0 or math.floor(value))
-    local command = 'SendMIDI "Control" ' .. channel .. '/' .. ccNumber .. ' ' .. midiValue
-    Cmd(command)
-    coroutine.yield(0.010) -- 10ms delay
+    queueMidi(wing, MIDI_PRIORITY_STATUS, channel, ccNumber, midiValue)
 end
 
-local function sendPageChange(pageNumber)
+local function sendPageChange(wing, pageNumber)
     local pageValue = pageNumber > 127 and 127 or (pageNumber < 1 and 1 or math.floor(pageNumber))
-    sendMidiStatus(pageMidiChannel, 1, pageValue)
-    DebugPrint("Page change sent: %d", pageValue)
+    -- Everything queued belongs to the old page, send it before the wing switches pages
+    flushMidiQueue(wing)
+    sendMidiStatus(wing, wing.pageChannel, 1, pageValue)
+    DebugPrint("Page change sent to %s: %d", wing.name, pageValue)
 end
 
 
-local function sendMidiColor(channel, ccBase, color)
-    -- Convert 0-255 color values to 0-127 MIDI values
-    local rMidi, gMidi, bMidi
-    
-    if color.r == 0 and color.g == 0 and color.b == 0 then
+-- Convert 0-255 color values to the 0-127 MIDI values the wing gets
+local function colorToMidi(r, g, b)
+    if r == 0 and g == 0 and b == 0 then
         -- If color is black (0,0,0), use default color for visibility
-        rMidi = math.floor((defaultRed / 255) * 127)
-        gMidi = math.floor((defaultGreen / 255) * 127)
-        bMidi = math.floor((defaultBlue / 255) * 127)
-    else
-        rMidi = math.floor((color.r / 255) * 127)
-        gMidi = math.floor((color.g / 255) * 127)
-        bMidi = math.floor((color.b / 255) * 127)
-    end
-    
-    sendMidiStatus(channel, ccBase, rMidi)     -- Red
-    sendMidiStatus(channel, ccBase + 1, gMidi) -- Green
-    sendMidiStatus(channel, ccBase + 2, bMidi) -- Blue
-end
-
--- Get cached executor state for comparison
-local function getCachedExecutorState(pageNum, execNum)
-    if not pageExecutorStates[pageNum] then
-        return nil, nil, nil, nil, nil -- No cached data for this page
-    end
-    
-    local cached = pageExecutorStates[pageNum][execNum]
-    if not cached then
-        return nil, nil, nil, nil, nil -- No cached data for this executor
-    end
-    
-    return cached.populated, cached.on, cached.colorR, cached.colorG, cached.colorB
-end
-
--- Cache executor state for future comparison
-local function setCachedExecutorState(pageNum, execNum, populated, on, colorR, colorG, colorB)
-    if not pageExecutorStates[pageNum] then
-        pageExecutorStates[pageNum] = {}
-    end
-    
-    pageExecutorStates[pageNum][execNum] = {
-        populated = populated,
-        on = on,
-        colorR = colorR,
-        colorG = colorG,
-        colorB = colorB,
-    }
+        return math.floor((defaultRed / 255) * 127), math.floor((defaultGreen / 255) * 127),
+               math.floor((defaultBlue / 255) * 127)
+    end
+    return math.floor((r / 255) * 127), math.floor((g / 255) * 127), math.floor((b / 255) * 127)
 end
 
--- Send fader sync for a specific executor (only when sequence assignment changes)
-local function sendFaderSync(execNum, xkeyNum, reason)
-    local currentPageNum = currentCyclePageNum
-    
-    -- Only send fader sync for executors 291-298 (XKeys 1-8) (Encoders 6-13)
-    if execNum < 291 or execNum > 298 then
+-- RGB CCs of an XKey: a wing with N XKeys has them at CC N+1 to 4N
+local function rgbCCBase(wing, key)
+    return wing.keyCount + (key - 1) * 3 + 1
+end
+
+local function sendMidiColor(wing, key, r, g, b, priority)
+    priority = priority or MIDI_PRIORITY_COLOR
+    local rMidi, gMidi, bMidi = colorToMidi(r, g, b)
+    local ccBase = rgbCCBase(wing, key)
+
+    queueMidi(wing, priority, wing.statusChannel, ccBase, rMidi)     -- Red
+    queueMidi(wing, priority, wing.statusChannel, ccBase + 1, gMidi) -- Green
+    queueMidi(wing, priority, wing.statusChannel, ccBase + 2, bMidi) -- Blue
+end
+
+-- Send fader sync for a specific XKey (sequence assignment / page changes)
+local function sendFaderSync(wing, key, reason)
+    -- Only XKeys with an absolute encoder get fader sync (executors 291-298, XKeys 1-8 by default)
+    local encoder = wing.encoderOf[key]
+    if not encoder then
         return false
     end
-    
-    
+
     -- Get current fader value to sync Teensy encoder tracking
-    local currentValue = getDirectExecutorInfo(execNum).faderValue
-    local faderCCNumber = startingCC + xkeyNum - 1
-    sendMidiFeedback(faderCCNumber, currentValue)
-    
-    DebugPrint("Executor %d (XKey %d): Fader sync=%d%% (CC:%d) - %s", 
-           execNum, xkeyNum, math.floor(currentValue), faderCCNumber, reason)
-    
-    -- Preserve cached state (no fader state tracking needed)
-    local cachedPopulated, cachedOn, cachedColorR, cachedColorG, cachedColorB = getCachedExecutorState(currentPageNum, execNum)
-    setCachedExecutorState(currentPageNum, execNum, cachedPopulated, cachedOn, cachedColorR, cachedColorG, cachedColorB)
-    
+    local execNum = wing.execs[key]
+    local currentValue = getExecutorFader(GetExecutor(execNum))
+    local faderCCNumber = startingCC + encoder - 1
+    sendMidiFeedback(wing, faderCCNumber, currentValue)
+    wing.lastFaderSent[key] = faderToMidi(currentValue)
+    wing.lastFaderSentCycle[key] = cycleCount
+
+    DebugPrint("Executor %d (XKey %d): Fader sync=%d%% (CC:%d) - %s",
+           execNum, key, math.floor(currentValue), faderCCNumber, reason)
+
     return true
 end
 
--- Send MIDI status for a specific executor 
-local function sendExecutorStatus(execNum, xkeyNum, force)
-    local currentPageNum = currentCyclePageNum
-    
+-- Send MIDI status for a specific XKey
+local function sendExecutorStatus(wing, key, force)
+    local execNum = wing.execs[key]
+    local cache = pageCache(wing, currentCyclePageNum)
+
     -- Get current states
-    local execInfo = getDirectExecutorInfo(execNum)
-    local isPopulated = execInfo.isPopulated
-    local isOn = execInfo.isOn  
-    local color = execInfo.color
-    
-    local populatedState = isPopulated
-    local onState = isOn
-    local colorR, colorG, colorB = color.r, color.g, color.b
-    
+    local isPopulated, isOn, colorR, colorG, colorB = readExecutorState(GetExecutor(execNum))
+
     -- Get cached state for comparison
-    local cachedPopulated, cachedOn, cachedColorR, cachedColorG, cachedColorB = getCachedExecutorState(currentPageNum, execNum)
-    
+    local cachedPopulated, cachedOn = cache.populated[key], cache.on[key]
+
     local messagesSent = 0
-    local statusChanged = force or (cachedPopulated ~= populatedState) or (cachedOn ~= onState)
-    local colorChanged = force or (cachedColorR ~= colorR) or (cachedColorG ~= colorG) or (cachedColorB ~= colorB)
+    local statusChanged = force or (cachedPopulated ~= isPopulated) or (cachedOn ~= isOn)
+    local colorChanged = force or (cache.r[key] ~= colorR) or (cache.g[key] ~= colorG) or (cache.b[key] ~= colorB)
     local sequenceChanged = false
-    
+
     -- Check if sequence assignment changed (for fader sync)
     local wasPopulated = cachedPopulated or false
     local becamePopulated = false
-    if statusChanged and execNum >= 291 and execNum <= 298 then
-        -- For executors 291-298, check if the populated state changed (sequence assignment)
-        if wasPopulated ~= populatedState then
+    if statusChanged and wing.encoderOf[key] then
+        -- For XKeys with encoders, check if the populated state changed (sequence assignment)
+        if wasPopulated ~= isPopulated then
             sequenceChanged = true
-            if not wasPopulated and populatedState then
+            if not wasPopulated and isPopulated then
                 becamePopulated = true
             end
         end
     else
-        -- For executors 191-198 (XKeys 9-16), check if became populated (hard-coded, no MIDI remote management)
-        if not wasPopulated and populatedState then
+        -- For the other XKeys (191-198 by default), check if became populated (no MIDI remote management)
+        if not wasPopulated and isPopulated then
             becamePopulated = true
         end
     end
-    
+
     -- Send status CC only if status changed
     if statusChanged then
         local statusValue = 0
@@ -334,223 +875,487 @@ local function sendExecutorStatus(execNum, xkeyNum, force)
         else
             statusValue = 0  -- Not populated
         end
-        
-        sendMidiStatus(statusMidiChannel, xkeyNum, statusValue)
+
+        sendMidiStatus(wing, wing.statusChannel, key, statusValue)
         messagesSent = messagesSent + 1
-        
-        DebugPrint("Executor %d (XKey %d): Status=%d (Pop=%s On=%s)", 
-               execNum, xkeyNum, statusValue,
+
+        DebugPrint("Executor %d (XKey %d): Status=%d (Pop=%s On=%s)",
+               execNum, key, statusValue,
                isPopulated and "YES" or "NO", isOn and "YES" or "NO")
-        
+
         -- Send fader sync if sequence assignment changed
         if sequenceChanged then
-            sendFaderSync(execNum, xkeyNum, "sequence assignment changed")
+            sendFaderSync(wing, key, "sequence assignment changed")
         end
     end
-    
+
     -- Send RGB if Key is populated AND color changed, OR Key just became populated (force RGB send for new sequences)
     if isPopulated and (colorChanged or becamePopulated) then
-        local rgbCCBase = 16 + (xkeyNum - 1) * 3 + 1
-        sendMidiColor(statusMidiChannel, rgbCCBase, color)
+        sendMidiColor(wing, key, colorR, colorG, colorB)
         messagesSent = messagesSent + 3
-        
+
         if becamePopulated then
-            DebugPrint("Executor %d (XKey %d): RGB=(%d,%d,%d) - newly populated", 
-                   execNum, xkeyNum, color.r, color.g, color.b)
+            DebugPrint("Executor %d (XKey %d): RGB=(%d,%d,%d) - newly populated",
+                   execNum, key, colorR, colorG, colorB)
         else
-            DebugPrint("Executor %d (XKey %d): RGB=(%d,%d,%d)", 
-                   execNum, xkeyNum, color.r, color.g, color.b)
+            DebugPrint("Executor %d (XKey %d): RGB=(%d,%d,%d)",
+                   execNum, key, colorR, colorG, colorB)
         end
     elseif not isPopulated and colorChanged then
-        DebugPrint("Executor %d (XKey %d): Unpopulated (no RGB sent)", execNum, xkeyNum)
+        DebugPrint("Executor %d (XKey %d): Unpopulated (no RGB sent)", execNum, key)
     end
-    
+
     -- Update cached state if anything was sent or changed
     if statusChanged or colorChanged then
-        setCachedExecutorState(currentPageNum, execNum, populatedState, onState, colorR, colorG, colorB)
+        setCachedExecutorState(cache, key, isPopulated, isOn, colorR, colorG, colorB)
     end
-    
+
     return messagesSent > 0 -- Indicate if we sent anything
 end
 
 -- Send full page data (startup or new page indexing)
-local function sendFullPageData(pageNum, reason)
-    DebugPrint("=== SENDING FULL PAGE DATA: Page %d (%s) ===", pageNum, reason)
+local function sendFullPageData(wing, pageNum, reason)
+    DebugPrint("=== SENDING FULL PAGE DATA: Page %d to %s (%s) ===", pageNum, wing.name, reason)
     local messagesSent = 0
-    
-    -- Send fader sync for executors 291-298 to initialize Teensy encoder tracking
-    for execNum = 291, 298 do
-        local xkeyNum = execNum - 290  -- 1-8
-        if sendFaderSync(execNum, xkeyNum, reason) then
+
+    -- Send fader sync for the XKeys with encoders to initialize Teensy encoder tracking
+    for _, key in ipairs(wing.encoderKeys) do
+        if sendFaderSync(wing, key, reason) then
             messagesSent = messagesSent + 1
         end
     end
-    
-    -- Send status data for all 16
-    for _, execNum in ipairs(EXECUTORS_TO_MONITOR) do
-        if execNum >= 291 and execNum <= 298 then
-            -- Executors 291-298 = XKeys 1-8
-            local xkeyNum = execNum - 290
-            if sendExecutorStatus(execNum, xkeyNum, true) then
-                messagesSent = messagesSent + 1
-            end
-        elseif execNum >= 191 and execNum <= 198 then
-            -- Executors 191-198 = XKeys 9-16  
-            local xkeyNum = execNum - 190
-            local actualXkeyNum = xkeyNum + 8
-            if sendExecutorStatus(execNum, actualXkeyNum, true) then
-                messagesSent = messagesSent + 1
-            end
+
+    -- Send status data for every XKey
+    for key = 1, wing.keyCount do
+        if sendExecutorStatus(wing, key, true) then
+            messagesSent = messagesSent + 1
         end
     end
-    
+
     -- Mark page as indexed
-    pageIndex[pageNum] = true
-    
+    wing.pageIndex[pageNum] = true
+
     DebugPrint("Full page data sent: %d messages", messagesSent)
 end
 
--- Send changes for current page
-local function sendChangedExecutors()
+-- Send changes for current page, only the XKeys change detection listed are read again
+local function sendChangedExecutors(wing)
     local messagesSent = 0
-    
-    local changedExecCount = 0
-    for _ in pairs(changedExecutors) do 
-        changedExecCount = changedExecCount + 1 
-    end
-    
-    DebugPrint("=== PROCESSING CHANGES ===\nChanged executors: %d", changedExecCount)
-    
-    -- Process all changed executors immediately
-    for execNum, _ in pairs(changedExecutors) do
-        if execNum >= 291 and execNum <= 298 then
-            -- Executors 291-298 = XKeys 1-8
-            local xkeyNum = execNum - 290  -- 1-8
-            
-            -- Send status data (includes fader sync if sequence changed)
-            if sendExecutorStatus(execNum, xkeyNum, false) then
-                messagesSent = messagesSent + 1
-                DebugPrint("Executor %d (XKey %d) status updated", execNum, xkeyNum)
-            end
-            
-        elseif execNum >= 191 and execNum <= 198 then
-            -- Executors 191-198 = XKeys 9-16
-            local xkeyNum = execNum - 190  -- 1-8
-            local actualXkeyNum = xkeyNum + 8  -- 9-16
-            
-            if sendExecutorStatus(execNum, actualXkeyNum, false) then
-                messagesSent = messagesSent + 1
-                DebugPrint("Executor %d (XKey %d) status updated", execNum, actualXkeyNum)
-            end
+    local changed = wing.changed
+
+    DebugPrint("=== PROCESSING CHANGES (%s) ===\nChanged executors: %d", wing.name, wing.changedCount)
+
+    -- Status data includes fader sync if the sequence changed
+    for i = 1, wing.changedCount do
+        local key = changed[i]
+        if sendExecutorStatus(wing, key, false) then
+            messagesSent = messagesSent + 1
+            DebugPrint("Executor %d (XKey %d) status updated", wing.execs[key], key)
         end
     end
-    
+
     -- Clear changed executors list after processing
-    changedExecutors = {}
-    
+    wing.changedCount = 0
+
     DebugPrint("Messages sent: %d", messagesSent)
 end
 
+
+-- BACKGROUND PAGE PREFETCH --
+
+-- Pages to go over in the next pass: neighbours closest first, then recently used pages
+local function addPrefetchPage(pageNum)
+    if pageNum >= 1 and pageNum <= 127 and not prefetchListed[pageNum] then
+        prefetchListed[pageNum] = true
+        prefetchList[#prefetchList + 1] = pageNum
+    end
+end
+
+local function buildPrefetchList()
+    local current = currentCyclePageNum
+    for pageNum in pairs(prefetchListed) do
+        prefetchListed[pageNum] = nil
+    end
+    prefetchListed[current] = true
+    clearList(prefetchList)
+    prefetchWing = 1
+    prefetchPos = 1
+
+    for distance = 1, prefetchNeighbours do
+        addPrefetchPage(current + distance)
+        addPrefetchPage(current - distance)
+    end
+    for _, pageNum in ipairs(recentPages) do
+        addPrefetchPage(pageNum)
+    end
+end
+
+-- Called when the current page changes, the left page joins the recent pages and the pass starts over
+local function notePageChange(oldPage, newPage)
+    if oldPage then
+        for i = #recentPages, 1, -1 do
+            if recentPages[i] == oldPage or recentPages[i] == newPage then
+                table.remove(recentPages, i)
+            end
+        end
+        table.insert(recentPages, 1, oldPage)
+        recentPages[prefetchRecentPages + 1] = nil
+    end
+
+    for _, wing in ipairs(wings) do
+        if oldPage then
+            -- The wing keeps the fader values it was last sent for the page it left
+            local faderSent = pageCache(wing, oldPage).fader
+            for _, key in ipairs(wing.encoderKeys) do
+                faderSent[key] = wing.lastFaderSent[key]
+            end
+        end
+        -- The new page is tracked live from here
+        local newCache = wing.pages[newPage]
+        if newCache then
+            for _, key in ipairs(wing.encoderKeys) do
+                newCache.fader[key] = nil
+            end
+        end
+    end
+
+    clearList(prefetchList)
+    prefetchWing = 1
+    prefetchPos = 1
+    prefetchNextPass = 0
+end
+
+-- Background messages are framed by the wing's write page (channel 3 CC 2), opened by the first message
+local function openPrefetchFrame(wing, pageNum)
+    if wing.prefetchFramePage ~= pageNum then
+        queueMidi(wing, MIDI_PRIORITY_PREFETCH, wing.pageChannel, 2, pageNum)
+        wing.prefetchFramePage = pageNum
+    end
+end
+
+local function queuePrefetch(wing, pageNum, channel, ccNumber, midiValue)
+    openPrefetchFrame(wing, pageNum)
+    queueMidi(wing, MIDI_PRIORITY_PREFETCH, channel, ccNumber, midiValue)
+    prefetchStats.messages = prefetchStats.messages + 1
+end
+
+-- Read one XKey of another page and queue what the wing doesn't have yet (everything when force)
+local function prefetchExecutor(wing, pageNum, key, force)
+    local exec = ObjectList(executorQuery(pageNum, wing.execs[key]))[1]
+    local isPopulated, isOn, colorR, colorG, colorB = readExecutorState(exec)
+    local cache = pageCache(wing, pageNum)
+    local cachedPopulated = cache.populated[key]
+
+    local statusChanged = force or (cachedPopulated ~= isPopulated) or (cache.on[key] ~= isOn)
+    local colorChanged = force or (cache.r[key] ~= colorR) or (cache.g[key] ~= colorG) or (cache.b[key] ~= colorB)
+
+    if statusChanged then
+        local statusValue = isPopulated and (isOn and 127 or 65) or 0
+        queuePrefetch(wing, pageNum, wing.statusChannel, key, statusValue)
+    end
+    if isPopulated and (colorChanged or not cachedPopulated) then
+        openPrefetchFrame(wing, pageNum)
+        sendMidiColor(wing, key, colorR, colorG, colorB, MIDI_PRIORITY_PREFETCH)
+        prefetchStats.messages = prefetchStats.messages + 3
+    end
+    if statusChanged or colorChanged then
+        setCachedExecutorState(cache, key, isPopulated, isOn, colorR, colorG, colorB)
+    end
+
+    -- Fader values for the XKeys with encoders, the wing loads them into the encoders on the page change
+    local encoder = wing.encoderOf[key]
+    if encoder then
+        local faderSent = cache.fader
+        local midiValue = faderToMidi(getExecutorFader(exec))
+        if force or faderSent[key] ~= midiValue then
+            queuePrefetch(wing, pageNum, wing.faderChannel, startingCC + encoder - 1, midiValue)
+            faderSent[key] = midiValue
+        end
+    end
+end
+
+-- Wing the prefetch continues with on pageNum, skipping finished wings and wings without the link
+-- (every message would cost 10ms of fixed pacing, that would hold up the next cycle)
+local function nextPrefetchWing(pageNum)
+    local wing = wings[prefetchWing]
+    while wing and (not wing.linkSequences or prefetchPos > wing.keyCount) do
+        if wing.linkSequences then
+            wing.pageIndex[pageNum] = true
+        end
+        prefetchWing = prefetchWing + 1
+        prefetchPos = 1
+        wing = wings[prefetchWing]
+    end
+    return wing
+end
+
+-- Index the next few executors of the prefetch pages, within prefetchBudget / prefetchMaxExecutors
+-- Runs after the cycle's own MIDI was flushed, and its messages queue behind anything live
+local function prefetchPages()
+    if not startupComplete then
+        return
+    end
+    if #prefetchList == 0 then
+        if cycleCount < prefetchNextPass then
+            return
+        end
+        buildPrefetchList()
+        prefetchNextPass = cycleCount + prefetchRescanCycles
+    end
+
+    local pageNum = prefetchList[1]
+    if not pageNum then
+        return
+    end
+    local start = os.clock()
+    local executors = 0
+
+    -- First pass over a page sends everything, like sendFullPageData()
+    local wing = nextPrefetchWing(pageNum)
+    while wing and executors < prefetchMaxExecutors and (os.clock() - start) < prefetchBudget do
+        prefetchExecutor(wing, pageNum, prefetchPos, not wing.pageIndex[pageNum])
+        prefetchPos = prefetchPos + 1
+        executors = executors + 1
+        wing = nextPrefetchWing(pageNum)
+    end
+    prefetchStats.executors = prefetchStats.executors + executors
+
+    -- Close the frames in the same flush so live messages never land inside them
+    for _, frameWing in ipairs(wings) do
+        if frameWing.prefetchFramePage then
+            queueMidi(frameWing, MIDI_PRIORITY_PREFETCH, frameWing.pageChannel, 2, 0)
+            frameWing.prefetchFramePage = nil
+        end
+    end
+
+    if not wing then
+        table.remove(prefetchList, 1)
+        prefetchWing = 1
+        prefetchPos = 1
+        prefetchStats.pages = prefetchStats.pages + 1
+        DebugPrint("Prefetched page %d (%d pages, %d messages so far)", pageNum, prefetchStats.pages, prefetchStats.messages)
+    end
+end
+
+
+-- PAGE DIGESTS --
+
+-- Same hash as the firmware's pageGroupDigest()
+local function digestValue(hash, value)
+    return (hash * 31 + value) % 16381
+end
+
+-- Ask the wing for the current page's digests and wait for the answer, nil without the digest link
+-- Both halves are needed, the low 7 bits alone would pass a group that differs 1 time in 128
+local function requestWingDigests(wing)
+    local numberSlot = LINK_SLOTS.digestNumber
+    local seqs = wing.linkSequences
+    if not (seqs and seqs[numberSlot.seq] and seqs[DIGEST_HIGH_SLOTS[1].seq]) then
+        return nil
+    end
+    if wing.digestRequest == 0 then
+        -- Continue after whatever the fader holds from an earlier run, so an old answer never matches
+        wing.digestRequest = readLinkValue(wing, numberSlot) or 0
+    end
+    wing.digestRequest = wing.digestRequest % 127 + 1
+    queueMidi(wing, MIDI_PRIORITY_STATUS, wing.linkChannel, 2, wing.digestRequest)
+    flushMidiQueue(wing)
+
+    for _ = 1, digestWaitPolls do
+        coroutine.yield(creditPollInterval)
+        if readLinkValue(wing, numberSlot) == wing.digestRequest then
+            for group, slot in ipairs(DIGEST_SLOTS) do
+                local low, high = readLinkValue(wing, slot), readLinkValue(wing, DIGEST_HIGH_SLOTS[group])
+                wingDigests[group] = (low and high) and (high * 128 + low) or -1
+            end
+            return wingDigests
+        end
+    end
+    digestStats.timeouts = digestStats.timeouts + 1
+    DebugPrint("No page digests from %s (request %d)", wing.name, wing.digestRequest)
+    return nil
+end
+
+-- After a page change: compare the wing's digests with the live executors and resend only the groups
+-- of XKeys that differ. Matching groups are taken as the cache, so change detection starts from them.
+-- Returns false when the wing didn't answer, the page is then sent the old way.
+local function syncPageFromDigests(wing, pageNum)
+    local digests = requestWingDigests(wing)
+    if not digests then
+        return false
+    end
+
+    local cache = pageCache(wing, pageNum)
+    local resent = 0
+    local populatedOf, onOf, rOf, gOf, bOf, faderOf =
+        snapshot.populated, snapshot.on, snapshot.r, snapshot.g, snapshot.b, snapshot.fader
+    for group, wingDigest in ipairs(digests) do
+        local firstKey = (group - 1) * wing.groupKeys + 1
+        local lastKey = math.min(firstKey + wing.groupKeys - 1, wing.keyCount)
+        local hash = 1
+        for key = firstKey, lastKey do
+            local exec = GetExecutor(wing.execs[key])
+            local populated, on, r, g, b = readExecutorState(exec)
+            populatedOf[key], onOf[key], rOf[key], gOf[key], bOf[key] = populated, on, r, g, b
+            hash = digestValue(hash, populated and (on and 127 or 65) or 0)
+            if populated then
+                local rMidi, gMidi, bMidi = colorToMidi(r, g, b)
+                hash = digestValue(digestValue(digestValue(hash, rMidi), gMidi), bMidi)
+            end
+            if wing.encoderOf[key] then
+                faderOf[key] = faderToMidi(getExecutorFader(exec))
+                hash = digestValue(hash, faderOf[key])
+            end
+        end
+
+        if hash == wingDigest then
+            digestStats.groupsMatched = digestStats.groupsMatched + 1
+            for key = firstKey, lastKey do
+                setCachedExecutorState(cache, key, populatedOf[key], onOf[key], rOf[key], gOf[key], bOf[key])
+                if faderOf[key] then
+                    wing.lastFaderSent[key] = faderOf[key]
+                    wing.lastFaderSentCycle[key] = cycleCount
+                end
+            end
+        else
+            digestStats.groupsResent = digestStats.groupsResent + 1
+            resent = resent + 1
+            for key = firstKey, lastKey do
+                -- sendExecutorStatus() syncs the fader itself when the populated state changes
+                local cachedPopulated = cache.populated[key]
+                sendExecutorStatus(wing, key, true)
+                if wing.encoderOf[key] and (cachedPopulated or false) == populatedOf[key] then
+                    sendFaderSync(wing, key, "page digest differs")
+                end
+            end
+        end
+    end
+
+    wing.pageIndex[pageNum] = true
+    digestStats.pages = digestStats.pages + 1
+    DebugPrint("Page %d digests (%s): %d of %d groups resent (%d pages, %d groups matched, %d resent, %d timeouts so far)",
+           pageNum, wing.name, resent, #digests, digestStats.pages, digestStats.groupsMatched, digestStats.groupsResent,
+           digestStats.timeouts)
+    return true
+end
+
+-- One read per XKey, compared against the wing's cached arrays; the keys that differ are listed in wing.changed
+local function detectChangedExecutors(wing)
+    local cache = pageCache(wing, currentCyclePageNum)
+    local populatedOf, onOf, rOf, gOf, bOf = cache.populated, cache.on, cache.r, cache.g, cache.b
+    local execs, changed = wing.execs, wing.changed
+    local count = 0
+
+    for key = 1, wing.keyCount do
+        local populated, on, r, g, b = readExecutorState(GetExecutor(execs[key]))
+        if populatedOf[key] ~= populated or onOf[key] ~= on or rOf[key] ~= r or gOf[key] ~= g or bOf[key] ~= b then
+            count = count + 1
+            changed[count] = key
+            DebugPrint("[CHANGE] Executor %d (XKey %d): Populated %s, On %s, RGB(%d,%d,%d)",
+                   execs[key], key, populated and "true" or "false", on and "true" or "false", r, g, b)
+        end
+    end
+
+    wing.changedCount = count
+    return count
+end
+
 local function checkForExecutorChanges()
     local currentPageNum = currentCyclePageNum
-    local contentChanged = false
-    local stateChanged = false
-    local colorChanged = false
-    local pageChanged = false
-    
+
     -- Check if page changed
     if currentPage == nil then
         -- First startup
         currentPage = currentPageNum
-        pageChanged = true
-        
+
         if not startupComplete then
             DebugPrint("=== STARTUP: Indexing page %d ===", currentPageNum)
-            sendPageChange(currentPageNum)
-            sendFullPageData(currentPageNum, "startup")
+            notePageChange(nil, currentPageNum)
+            for _, wing in ipairs(wings) do
+                sendPageChange(wing, currentPageNum)
+                sendFullPageData(wing, currentPageNum, "startup")
+            end
             startupComplete = true
-            return -- Exit early after startup
         end
-        
+        return -- Exit early after startup
+
     elseif currentPage ~= currentPageNum then
         -- Page actually changed
         DebugPrint("=== PAGE CHANGE: %d → %d ===", currentPage, currentPageNum)
+        notePageChange(currentPage, currentPageNum)
         currentPage = currentPageNum
-        pageChanged = true
-        
-        -- Send page change notification
-        sendPageChange(currentPageNum)
-        
-        -- Check if this page has been indexed before
-        if not pageIndex[currentPageNum] then
-            -- New page - send full data including fader sync
-            DebugPrint("New page detected - sending full data")
-            sendFullPageData(currentPageNum, "new page")
-            return -- Exit early after full page send
-        else
-            -- Known page - send fader sync for encoder tracking, then let normal change detection handle differences
-            DebugPrint("Returning to known page %d - sending fader sync", currentPageNum)
-            for execNum = 291, 298 do
-                local xkeyNum = execNum - 290  -- 1-8
-                sendFaderSync(execNum, xkeyNum, "known page change")
+
+        for _, wing in ipairs(wings) do
+            -- Send page change notification
+            sendPageChange(wing, currentPageNum)
+
+            -- The wing's page digests tell which groups of XKeys it already has right, only the others are resent
+            local synced = syncPageFromDigests(wing, currentPageNum)
+
+            -- Without them, check if this page has been indexed before
+            if synced then
+                DebugPrint("Page %d synced from the digests of %s", currentPageNum, wing.name)
+            elseif not wing.pageIndex[currentPageNum] then
+                -- New page - send full data including fader sync
+                DebugPrint("New page detected - sending full data")
+                sendFullPageData(wing, currentPageNum, "new page")
+            else
+                -- Known page - send fader sync for encoder tracking, change detection handles differences next cycle
+                DebugPrint("Returning to known page %d - sending fader sync", currentPageNum)
+                for _, key in ipairs(wing.encoderKeys) do
+                    sendFaderSync(wing, key, "known page change")
+                end
             end
         end
+        return -- Changes are picked up next cycle, against the cache the page change left
     end
-    
-    -- Check for executor state changes
-    for _, execNum in ipairs(EXECUTORS_TO_MONITOR) do
 
-            local execInfo = getDirectExecutorInfo(execNum)
-            local currentObject = execInfo.object
-            local isPopulated = execInfo.isPopulated
-            local currentOnState = execInfo.isOn
-            local currentColor = execInfo.color
-            
-            -- Get cached state for comparison 
-            local cachedPopulated, cachedOn, cachedColorR, cachedColorG, cachedColorB = getCachedExecutorState(currentPageNum, execNum)
-            
-            local executorChanged = false
-            
-            -- Check if status changed from cached state
-            if (cachedPopulated ~= isPopulated) or (cachedOn ~= currentOnState) then
-                DebugPrint("[CHANGE] Executor %d: Status changed (Populated: %s, On: %s)", 
-                       execNum, isPopulated and "true" or "false", currentOnState and "true" or "false")
-                executorChanged = true
-                contentChanged = true
-                stateChanged = true
-            end
-            
-            -- Check if color changed from cached state
-            if (cachedColorR ~= currentColor.r) or (cachedColorG ~= currentColor.g) or (cachedColorB ~= currentColor.b) then
-                DebugPrint("[CHANGE] Executor %d: Color changed to RGB(%d,%d,%d)", 
-                       execNum, currentColor.r, currentColor.g, currentColor.b)
-                executorChanged = true
-                colorChanged = true
-            end
-            
-            -- Mark executor as changed if any property changed
-            if executorChanged then
-                changedExecutors[execNum] = true
-            end
+    -- Check for executor state changes
+    local changedCount = 0
+    for _, wing in ipairs(wings) do
+        changedCount = changedCount + detectChangedExecutors(wing)
     end
-    
-    -- Send feedback if anything changed (but not for page changes - handled above)
-    if not pageChanged and (contentChanged or stateChanged or colorChanged) then
-        if contentChanged then
-            DebugPrint("=== Executor content changes detected ===")
-        end
-        if stateChanged then
-            DebugPrint("=== Executor state changes detected ===")
-        end
-        if colorChanged then
-            DebugPrint("=== Executor color changes detected ===")
-        end
-        
+
+    -- Send feedback if anything changed
+    if changedCount > 0 then
+        DebugPrint("=== Executor changes detected: %d ===", changedCount)
+
         -- Small delay for grandMA to finish processing the changes
         coroutine.yield(0.1) -- 100ms delay
-        
+
         DebugPrint("=== Sending MIDI updates ===")
-        sendChangedExecutors()
+        for _, wing in ipairs(wings) do
+            if wing.changedCount > 0 then
+                sendChangedExecutors(wing)
+            end
+        end
+    end
+end
+
+
+-- Send fader positions that moved in software since they were last sent
+-- Runs every cycle: one GetFader read per XKey with an encoder, nothing is sent unless a fader moved past the deadband
+local function trackFaderPositions()
+    cycleCount = cycleCount + 1
+
+    for _, wing in ipairs(wings) do
+        local lastFaderSent, lastFaderSentCycle = wing.lastFaderSent, wing.lastFaderSentCycle
+        for encoder, key in ipairs(wing.encoderKeys) do
+            local lastSent = lastFaderSent[key]
+            -- Untracked executors get their first value from sendFaderSync (startup/page change)
+            if lastSent and (cycleCount - lastFaderSentCycle[key]) >= faderSyncCycles then
+                local execNum = wing.execs[key]
+                local midiValue = faderToMidi(getExecutorFader(GetExecutor(execNum)))
+                if math.abs(midiValue - lastSent) >= faderDeadband then
+                    local ccNumber = startingCC + encoder - 1
+                    queueMidi(wing, MIDI_PRIORITY_STATUS, wing.faderChannel, ccNumber, midiValue)
+                    lastFaderSent[key] = midiValue
+                    lastFaderSentCycle[key] = cycleCount
+                    DebugPrint("Executor %d (XKey %d): Fader moved - sync=%d (CC:%d)",
+                           execNum, key, midiValue, ccNumber)
+                end
+            end
+        end
     end
 end
 
@@ -572,35 +1377,74 @@ local function createMidiRemotes(chosenPressKey)
         return
     end
 
-    -- Create 16 midi remotes
-    local desired = {}
-    -- Rotate (CC 6–13)
-    for i = 1, 8 do
-        table.insert(desired, {
-            name = ("XKeyRotate%d"):format(i),
-            kind = "Control",
-            chan = 1,
-            cc   = 5 + i  -- 6-13
-        })
-    end
-    -- Press (Note 6–13)
-    for i = 1, 8 do
-        table.insert(desired, {
-            name = ("XKeyPress%d"):format(i),
-            kind = "Note",
-            chan = 1,
-            note = 5 + i, -- 6-13
-            keyAction = chosenPressKey
-        })
-    end
-
-    -- Build a lookup of existing remotes by name
+    -- Created from the menu before the first Start
+    if #wings == 0 then
+        buildWings()
+    end
+
+    -- Build a lookup of existing sequences and remotes by name
     local existing = {}
     for _, r in pairs(midiPool:Children()) do
         if r.name then
             existing[r.name] = r
         end
     end
+    local sequences = {}
+    for _, seq in pairs(DataPool().Sequences:Children()) do
+        if seq.name then
+            sequences[seq.name] = seq
+        end
+    end
+
+    -- Per wing: XKeyRotate/XKeyPress remotes for the XKeys with encoders, EvoLink remotes and link sequences
+    local desired = {}
+    for _, wing in ipairs(wings) do
+        local encoderCount = #wing.encoderKeys
+        -- Rotate (CC 6 up)
+        for i = 1, encoderCount do
+            table.insert(desired, {
+                name = ("XKeyRotate%d%s"):format(i, wing.suffix),
+                kind = "Control",
+                chan = wing.faderChannel,
+                cc   = startingCC + i - 1
+            })
+        end
+        -- Press (Note 6 up)
+        for i = 1, encoderCount do
+            table.insert(desired, {
+                name = ("XKeyPress%d%s"):format(i, wing.suffix),
+                kind = "Note",
+                chan = wing.faderChannel,
+                note = startingCC + i - 1,
+                keyAction = chosenPressKey
+            })
+        end
+
+        -- Create the link sequences the EvoLink remotes target
+        local linkSeqs = {}
+        for i, name in ipairs(LINK_SEQUENCE_NAMES) do
+            local seqName = name .. wing.suffix
+            local seq = sequences[seqName]
+            if not seq then
+                seq = DataPool().Sequences:Append()
+                Cmd('Set ' .. seq:ToAddr() .. ' Property "Name" "' .. seqName .. '"')
+                sequences[seqName] = seq
+            end
+            linkSeqs[i] = seq
+        end
+
+        -- Wing link (channel 4 CCs driving the link sequence faders)
+        for _, slot in pairs(LINK_SLOTS) do
+            table.insert(desired, {
+                name = slot.name .. wing.suffix,
+                kind = "Link",
+                chan = wing.linkChannel,
+                cc   = slot.cc,
+                seq  = linkSeqs[slot.seq],
+                fader = slot.fader
+            })
+        end
+    end
 
     local created = {}
     local updated = {}
@@ -623,6 +1467,13 @@ local function createMidiRemotes(chosenPressKey)
             Cmd('Set ' .. addr .. ' Property "MIDITYPE" 3')   -- Control
             setProp("MIDIINDEX", spec.cc, false)
             setProp("KEY", "", true)
+        elseif spec.kind == "Link" then
+            -- EvoLink: CC moves one fader of a link sequence
+            Cmd('Set ' .. addr .. ' Property "MIDITYPE" 3')   -- Control
+            setProp("MIDIINDEX", spec.cc, false)
+            setProp("KEY", "", true)
+            r.target = spec.seq
+            setProp("FADER", spec.fader, true)
         else
             -- XKeyPress: Note
             Cmd('Set ' .. addr .. ' Property "MIDITYPE" 0')   -- Note
@@ -668,114 +1519,217 @@ local function createMidiRemotes(chosenPressKey)
 end
 
 
-local function parseMidiRemotes()
-    -- Cache XKey remotes on first run, then only process cached ones
-    
-    if not remoteCacheComplete then
-        -- INITIAL SCAN: Find and cache all XKey remotes
-        cachedXKeyRemotes = {}  -- Clear any partial cache
-        local foundCount = 0
-        
-        for key, remote in pairs(Root().ShowData.Remotes.MIDIRemotes:Children()) do
-            local name = remote.name
-            local nameUpper = name:upper()
-            
-            if string.match(nameUpper, "^XKEYROTATE%d+$") or string.match(nameUpper, "^XKEYPRESS%d+$") then
-                local exec = getXKeyMapping(remote.name)
-                if exec ~= nil then
-                    -- Cache this remote with its exec info
-                    table.insert(cachedXKeyRemotes, {
+-- XKey of a remote name on a wing: XKeyRotate<n><suffix> / XKeyPress<n><suffix>, n = encoder number
+local function getXKeyMapping(wing, remoteName)
+    local remoteType = "Fader"
+    local encoderNum = remoteName:match(wing.rotatePattern)
+    if not encoderNum then
+        remoteType = "Key"
+        encoderNum = remoteName:match(wing.pressPattern)
+    end
+    local key = encoderNum and wing.encoderKeys[tonumber(encoderNum)]
+    if key then
+        return key, remoteType
+    end
+    return nil
+end
+
+-- Cache the XKey remotes of every wing that doesn't have all of them yet, one pass over the pool
+-- Returns false when a wing has none at all (remotes were never created)
+local function scanMidiRemotes()
+    local scanning = remoteScanList
+    clearList(scanning)
+    for _, wing in ipairs(wings) do
+        if not wing.remoteCacheComplete then
+            wing.cachedRemotes = {} -- Clear any partial cache
+            scanning[#scanning + 1] = wing
+        end
+    end
+    if #scanning == 0 then
+        return true
+    end
+
+    for _, remote in pairs(Root().ShowData.Remotes.MIDIRemotes:Children()) do
+        local name = remote.name
+        if name then
+            for _, wing in ipairs(scanning) do
+                local key, remoteType = getXKeyMapping(wing, name)
+                if key then
+                    -- Cache this remote with its XKey
+                    table.insert(wing.cachedRemotes, {
                         remote = remote,
-                        exec = exec,
-                        name = remote.name
+                        key = key,
+                        type = remoteType,
+                        name = name
                     })
-                    foundCount = foundCount + 1
+                    break
                 end
             end
         end
-        
-        if foundCount >= expectedRemoteCount then
-            remoteCacheComplete = true
-            DebugPrint("MIDI remotes cached: %d/%d found", foundCount, expectedRemoteCount)
+    end
+
+    local allFound = true
+    for _, wing in ipairs(scanning) do
+        local foundCount = #wing.cachedRemotes
+        local expectedCount = #wing.encoderKeys * 2 -- XKeyRotate + XKeyPress per encoder
+        if foundCount >= expectedCount then
+            wing.remoteCacheComplete = true
+            DebugPrint("MIDI remotes cached (%s): %d/%d found", wing.name, foundCount, expectedCount)
         elseif foundCount > 0 then
-            DebugPrint("MIDI remotes: %d/%d found (scanning...)", foundCount, expectedRemoteCount)
+            DebugPrint("MIDI remotes (%s): %d/%d found (scanning...)", wing.name, foundCount, expectedCount)
         else
-            -- Missing Midi Remotes create them
-            Printf("WARNING: No XKey remotes found - Creating Remote with defualt Toggle for Press")
-            createMidiRemotes()
+            allFound = false
+        end
+    end
+    return allFound
+end
 
-            clearAllCachedState()
-            running = true
-            Printf("Remotes created. Restarting EvoCmdWingMidi…")
-            loop()
-            return
+-- Point a wing's cached remotes at the objects of the XKeys that changed, returns false when a remote is gone
+local function retargetWingRemotes(wing, pageChanged)
+    local retargetKeys, targetObjects = wing.retargetKeys, wing.remoteTargetObjects
+
+    -- Cheap signature: current page plus the object assigned to each XKey with an encoder
+    local anyChanged = pageChanged
+    for _, key in ipairs(wing.encoderKeys) do
+        local exec = GetExecutor(wing.execs[key])
+        local currentObject = exec and exec.Object or nil
+        if pageChanged or targetObjects[key] ~= currentObject then
+            targetObjects[key] = currentObject
+            retargetKeys[key] = true
+            anyChanged = true
+        else
+            retargetKeys[key] = false
         end
     end
-    
-    -- Process only cached remotes
-    if remoteCacheComplete then
-        for _, cachedRemote in pairs(cachedXKeyRemotes) do
-            local remote = cachedRemote.remote
-            local exec = cachedRemote.exec
-            
-            -- Validate remote still exists
-            if remote and remote.name then
-                -- Update exec info with current page (page may have changed)
-                exec.page = currentCyclePageNum
-                
-                -- Always update the target object
-                local currentObject = getDirectExecutorInfo(exec.id).object
-                if remote.target ~= currentObject then
-                    remote.target = currentObject
+    wing.remoteTargetPage = currentCyclePageNum
+
+    if not anyChanged then
+        return true -- Steady state, no remote work
+    end
+    remoteStats.retargetCycles = remoteStats.retargetCycles + 1
+
+    local faderRefs = wing.faderRefs -- Looked up once per XKey, shared by its XKeyRotate and XKeyPress remotes
+    for _, key in ipairs(wing.encoderKeys) do
+        faderRefs[key] = nil
+    end
+    local visited, writes = 0, 0
+
+    for _, cachedRemote in ipairs(wing.cachedRemotes) do
+        local remote = cachedRemote.remote
+        local key = cachedRemote.key
+
+        -- Validate remote still exists
+        if not (remote and remote.name) then
+            -- Remote no longer exists - invalidate cache and restart scanning
+            DebugPrint("MIDI remote cache invalid (%s) - rescanning", wing.name)
+            wing.cachedRemotes = {}
+            wing.remoteCacheComplete = false
+            wing.remoteTargetPage = nil
+            return false -- Exit and let next cycle rebuild cache
+        end
+
+        if retargetKeys[key] then
+            visited = visited + 1
+
+            local currentObject = targetObjects[key]
+            if remote.target ~= currentObject then
+                remote.target = currentObject
+                writes = writes + 1
+            end
+
+            if remote.target == nil then
+                -- No target assigned, clear fader but preserve manual key settings for XKeyPress
+                if cachedRemote.type == "Fader" then
+                    -- XKeyRotate: clear both key and fader
+                    if remote.key ~= "" then
+                        remote.key = ""
+                        writes = writes + 1
+                    end
                 end
-                
-                if remote.target == nil then
-                    -- No target assigned, clear fader but preserve manual key settings for XKeyPress
-                    if exec.type == "Fader" then
-                        -- XKeyRotate: clear both key and fader
-                        if remote.key ~= "" then
-                            remote.key = ""
-                        end
+                -- Always clear fader for both types when no target
+                if remote.fader ~= "" then
+                    remote.fader = ""
+                    writes = writes + 1
+                end
+                -- For XKeyPress (type == "Key"), we keep the manual key setting
+            else
+                if cachedRemote.type == "Fader" then
+                    -- XKeyRotate: Handle fader control
+                    if remote.key ~= "" then
+                        remote.key = ""
+                        writes = writes + 1
+                    end
+                    if faderRefs[key] == nil then
+                        faderRefs[key] = getExecutorFaderRef(wing.execs[key]) or false
+                    end
+                    local currentFaderRef = faderRefs[key] or nil
+                    if remote.fader ~= currentFaderRef then
+                        remote.fader = currentFaderRef
+                        writes = writes + 1
                     end
-                    -- Always clear fader for both types when no target
+                elseif cachedRemote.type == "Key" then
+                    -- XKeyPress: Only target assignment, leave key action for manual config
                     if remote.fader ~= "" then
                         remote.fader = ""
-                    end
-                    -- For XKeyPress (exec.type == "Key"), we keep the manual key setting
-                else
-                    if exec.type == "Fader" then
-                        -- XKeyRotate: Handle fader control
-                        if remote.key ~= "" then
-                            remote.key = ""
-                        end
-                        local currentFaderRef = getDirectExecutorInfo(exec.id).faderRef
-                        if remote.fader ~= currentFaderRef then
-                            remote.fader = currentFaderRef
-                        end
-                    elseif exec.type == "Key" then
-                        -- XKeyPress: Only target assignment, leave key action for manual config
-                        if remote.fader ~= "" then
-                            remote.fader = ""
-                        end
+                        writes = writes + 1
                     end
                 end
-            else
-                -- Remote no longer exists - invalidate cache and restart scanning
-                DebugPrint("MIDI remote cache invalid - rescanning")
-                cachedXKeyRemotes = {}
-                remoteCacheComplete = false
-                return  -- Exit and let next cycle rebuild cache
             end
         end
     end
+
+    remoteStats.remotesVisited = remoteStats.remotesVisited + visited
+    remoteStats.remoteWrites = remoteStats.remoteWrites + writes
+    DebugPrint("MIDI remotes retargeted (%s, %s): %d remotes visited, %d property writes",
+           wing.name, pageChanged and "page change" or "assignment change", visited, writes)
+    return true
+end
+
+local function parseMidiRemotes()
+    -- Cache XKey remotes on first run, then only process cached ones
+    if not scanMidiRemotes() then
+        -- Missing Midi Remotes create them
+        Printf("WARNING: No XKey remotes found - Creating Remote with defualt Toggle for Press")
+        createMidiRemotes()
+
+        clearAllCachedState()
+        running = true
+        Printf("Remotes created. Restarting EvoCmdWingMidi…")
+        loop()
+        return
+    end
+
+    -- Process only cached remotes, and only when their targets can have changed
+    remoteStats.cycles = remoteStats.cycles + 1
+    for _, wing in ipairs(wings) do
+        if wing.remoteCacheComplete and #wing.cachedRemotes > 0 then
+            retargetWingRemotes(wing, wing.remoteTargetPage ~= currentCyclePageNum)
+        end
+    end
+
+    if remoteStats.cycles % remoteStatsReportCycles == 0 then
+        DebugPrint("MIDI remotes: retargeted in %d of %d cycles (%d remotes visited, %d property writes)",
+               remoteStats.retargetCycles, remoteStats.cycles, remoteStats.remotesVisited, remoteStats.remoteWrites)
+    end
 end
 
 loop = function()
+    armGcSentinel()
     while running do
+        local cycleStartKB = collectgarbage("count")
         currentCyclePageNum = CurrentExecPage().no
-        
+
         parseMidiRemotes()
         checkForExecutorChanges()
+        trackFaderPositions()
+        flushAllWings()
+        for _, wing in ipairs(wings) do
+            pingWing(wing)
+        end
+        prefetchPages()
+        flushAllWings()
+        reportCycleStats()
+        reportMemoryStats(cycleStartKB)
         coroutine.yield(rate)
     end
 end
@@ -857,18 +1811,33 @@ function main()
             
             running = true
             Printf("Starting -- EvoCmdWingMidi v0.2...")
-            Printf("Monitoring: Executors 191-198 and 291-298")
-            Printf("XKeyRotate1-8: MIDI Channel %d, CC %d-%d (with feedback)", midiChannel, startingCC, (startingCC + 7))
-            Printf("XKeyPress1-8: MIDI Channel %d, CC %d-%d (no feedback)", midiChannel, startingCC, (startingCC + 7))
-            Printf("Status Data on Channel %d :", statusMidiChannel)
-            Printf("  Status: XKeys 1-16 use CC 1-16")
-            Printf("    0 = Not populated")
-            Printf("    65 = Populated and off") 
-            Printf("    127 = Populated and on")
-            Printf("  RGB: XKeys 1-16 use CC 17-64 (3 CCs each)")
-            Printf("Page Changes on Channel %d:", pageMidiChannel)
+            for _, wing in ipairs(wings) do
+                local ranges = {}
+                for i, range in ipairs(wing.ranges) do
+                    ranges[i] = range.first .. "-" .. range.last
+                end
+                local encoders = #wing.encoderKeys
+                Printf("%s: Executors %s (XKeys 1-%d), MIDI Channels %d-%d", wing.name, table.concat(ranges, " and "),
+                       wing.keyCount, wing.faderChannel, wing.linkChannel)
+                if encoders > 0 then
+                    Printf("  XKeyRotate1-%d%s: MIDI Channel %d, CC %d-%d (with feedback)", encoders, wing.suffix,
+                           wing.faderChannel, startingCC, startingCC + encoders - 1)
+                    Printf("  XKeyPress1-%d%s: MIDI Channel %d, Note %d-%d (no feedback)", encoders, wing.suffix,
+                           wing.faderChannel, startingCC, startingCC + encoders - 1)
+                end
+                Printf("  Status: XKeys 1-%d use Channel %d CC 1-%d", wing.keyCount, wing.statusChannel, wing.keyCount)
+                Printf("    0 = Not populated")
+                Printf("    65 = Populated and off") 
+                Printf("    127 = Populated and on")
+                Printf("  RGB: XKeys 1-%d use Channel %d CC %d-%d (3 CCs each)", wing.keyCount, wing.statusChannel,
+                       wing.keyCount + 1, wing.keyCount * 4)
+            end
+            Printf("Page Changes on the third Channel of each wing (%d for the first):", pageMidiChannel)
             Printf("  CC 1 = Current page number (1-127)")
-            Printf("  Smart fader sync for XKeys 1-8 (Channel %d, CC %d-%d)", midiChannel, startingCC, (startingCC + 7))
+            Printf("  CC 2 = Write page for background prefetch (1-127, 0 = current page)")
+            Printf("  Smart fader sync for the XKeys with encoders (first Channel of each wing, CC %d up)", startingCC)
+            Printf("Wing Link on the fourth Channel of each wing (%d for the first): credit based MIDI pacing (EvoLink remotes)", linkMidiChannel)
+            Printf("  Ping every %d cycles, round trip shown in debug mode", pingInterval)
             Printf("  NOTE: Restart this script if you reset the Teensy OR change MIDI remote names to resync!")
             loop()
         end
@@ -889,4 +1858,5 @@ function main()
     end
 end
 
-return main
\ No newline at end of file
+
+return main
@@ -0,0 +1,39 @@
+-- Example show for run_plugin.lua
+-- Two pages of XKey executors (191-198 buttons, 291-298 encoders) and a few scripted playback changes
+
+return {
+    duration = 10,  -- Simulated seconds
+    startPage = 1,
+
+    -- Wing model, answers credit requests like the firmware's receive ring (128 slots - 8 reserved)
+    wing = {credits = 120},
+
+    sequences = {
+        [1] = {name = "Front Wash", color = {255, 0, 0}},
+        [2] = {name = "Back Wash",  color = {0, 0, 255}, on = true},
+        [3] = {name = "Spots",      color = {255, 255, 0}, fader = 50},
+        [4] = {name = "Strobe",     color = {0, 0, 0}},
+        [5] = {name = "Haze",       color = {0, 255, 0}, fader = 25},
+        [6] = {name = "Audience",   color = {255, 128, 0}},
+    },
+
+    -- [page] = {[execNum] = sequence}
+    pages = {
+        [1] = {[191] = 1, [192] = 2, [193] = 4, [291] = 1, [292] = 2, [293] = 3, [294] = 5},
+        [2] = {[191] = 3, [195] = 6, [291] = 6, [295] = 5, [298] = 4},
+    },
+
+    -- {t = seconds, action = ...}, see StandIn:apply()
+    events = {
+        {t = 1.0, action = "on", sequence = 1},
+        {t = 1.5, action = "fader", sequence = 3, value = 80},
+        {t = 2.0, action = "color", sequence = 2, color = {255, 0, 255}},
+        {t = 3.0, action = "page", page = 2},
+        {t = 4.0, action = "midi", channel = 1, cc = 6, value = 64},
+        {t = 5.0, action = "assign", page = 2, exec = 296, sequence = 1},
+        {t = 6.0, action = "page", page = 1},
+        {t = 7.0, action = "off", sequence = 2},
+        {t = 8.0, action = "page", page = 3},
+        {t = 9.0, action = "page", page = 1},
+    },
+}
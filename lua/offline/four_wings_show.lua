@@ -0,0 +1,59 @@
+-- Four wing show for run_plugin.lua
+-- 64 monitored executors: four wings of 16 XKeys on channel blocks 1-4, 5-8, 9-12 and 13-16,
+-- each with 8 encoder executors and 8 button executors (291-298 + 191-198, 281-288 + 181-188, and so on)
+
+local wings = {}
+local pages = {[1] = {}, [2] = {}}
+for i = 1, 4 do
+    local encoderBase = 300 - i * 10 -- 290, 280, 270, 260
+    wings[i] = {
+        name = "Wing " .. i,
+        channelBase = (i - 1) * 4,
+        ranges = {
+            {first = encoderBase + 1, last = encoderBase + 8, encoders = true},
+            {first = encoderBase - 99, last = encoderBase - 92},
+        },
+    }
+    -- Every wing gets the same layout, shifted by one sequence
+    pages[1][encoderBase + 1] = (i - 1) % 6 + 1
+    pages[1][encoderBase + 2] = i % 6 + 1
+    pages[1][encoderBase + 3] = 3
+    pages[1][encoderBase - 99] = 2
+    pages[1][encoderBase - 98] = (i + 2) % 6 + 1
+    pages[2][encoderBase + 5] = 5
+    pages[2][encoderBase - 95] = 6
+end
+
+return {
+    duration = 10,  -- Simulated seconds
+    startPage = 1,
+
+    -- Wing model, answers credit requests like the firmware's receive ring (128 slots - 8 reserved)
+    wing = {credits = 120},
+    wings = wings,
+
+    sequences = {
+        [1] = {name = "Front Wash", color = {255, 0, 0}},
+        [2] = {name = "Back Wash",  color = {0, 0, 255}, on = true},
+        [3] = {name = "Spots",      color = {255, 255, 0}, fader = 50},
+        [4] = {name = "Strobe",     color = {0, 0, 0}},
+        [5] = {name = "Haze",       color = {0, 255, 0}, fader = 25},
+        [6] = {name = "Audience",   color = {255, 128, 0}},
+    },
+
+    -- [page] = {[execNum] = sequence}
+    pages = pages,
+
+    -- {t = seconds, action = ...}, see StandIn:apply()
+    events = {
+        {t = 1.0, action = "on", sequence = 1},
+        {t = 1.5, action = "fader", sequence = 3, value = 80},
+        {t = 2.0, action = "color", sequence = 2, color = {255, 0, 255}},
+        {t = 3.0, action = "page", page = 2},
+        {t = 4.0, action = "midi", channel = 9, cc = 6, value = 64},
+        {t = 5.0, action = "assign", page = 2, exec = 266, sequence = 1},
+        {t = 6.0, action = "page", page = 1},
+        {t = 7.0, action = "off", sequence = 2},
+        {t = 9.0, action = "page", page = 2},
+    },
+}
@@ -0,0 +1,490 @@
+-- EvoCmdWingMidi offline - grandMA3 API stand-in
+-- Models the part of the grandMA3 Lua API that evocmdwingmidi_main.lua uses, on top of a scripted show,
+-- so the plugin can run under stock Lua 5.x without a desk:
+--     GetExecutor, CurrentExecPage, ObjectList, Root().ShowData.Remotes.MIDIRemotes, DataPool().Sequences,
+--     Cmd (SendMIDI and 'Set ... Property'), Printf, PopupInput, GetFocusDisplay, Time (simulated clock)
+-- Every API call is counted and every SendMIDI is recorded, see run_plugin.lua for the runner
+
+local StandIn = {}
+StandIn.__index = StandIn
+
+-- Fader tokens a sequence can be read/written by (GetFader / MIDI remote FADER property)
+local FADER_TOKENS = {
+    Master = "FaderMaster", X = "FaderX", XA = "FaderXA", XB = "FaderXB",
+    Temp = "FaderTemp", Rate = "FaderRate", Speed = "FaderSpeed", Time = "FaderTime",
+}
+
+-- ================================
+-- SHOW OBJECTS
+-- ================================
+
+local Sequence = {}
+Sequence.__index = Sequence
+
+local function newSequence(api, no, spec)
+    local color = spec.color or {0, 0, 0}
+    local seq = setmetatable({
+        api = api,
+        no = no,
+        name = spec.name or ("Sequence " .. no),
+        active = spec.on or false,
+        faders = {FaderMaster = spec.fader or 100},
+        APPEARANCE = {BACKR = color[1], BACKG = color[2], BACKB = color[3]},
+    }, Sequence)
+    return seq
+end
+
+function Sequence:HasActivePlayback()
+    self.api:count("Object:HasActivePlayback")
+    return self.active
+end
+
+function Sequence:GetFader(args)
+    self.api:count("Object:GetFader")
+    return self.faders[args.token or "FaderMaster"] or 0
+end
+
+function Sequence:ToAddr()
+    return "Sequence " .. self.no
+end
+
+function Sequence:Children()
+    return {}
+end
+
+-- Executor handle for one page/executor number, its fader is the assigned sequence's master
+-- Handles are made once per page and executor (see StandIn:executorHandle()) so the stand-in doesn't allocate per call
+local Executor = {}
+Executor.__index = function(exec, key)
+    if key == "Object" then
+        exec.api:count("Executor.Object")
+        return exec.api:assignedSequence(exec.page, exec.no)
+    elseif key == "fader" then
+        return exec.api:assignedSequence(exec.page, exec.no) and "Master" or ""
+    end
+    return Executor[key]
+end
+
+function Executor:GetFader(args)
+    self.api:count("Executor:GetFader")
+    local seq = self.api:assignedSequence(self.page, self.no)
+    if not seq then
+        return 0
+    end
+    return seq.faders[args.token or "FaderMaster"] or 0
+end
+
+-- MIDI remote, properties are plain fields (name, target, key, fader, midichannel, miditype, midiindex)
+local Remote = {}
+Remote.__index = Remote
+
+function Remote:ToAddr()
+    return "MIDIRemote " .. self.no
+end
+
+-- Pool with Children()/Append() like grandMA3 object pools
+local Pool = {}
+Pool.__index = Pool
+
+local function newPool(api, name, factory)
+    return setmetatable({api = api, name = name, items = {}, factory = factory}, Pool)
+end
+
+function Pool:Children()
+    self.api:count(self.name .. ":Children")
+    local list = {}
+    for i, item in ipairs(self.items) do
+        list[i] = item
+    end
+    return list
+end
+
+function Pool:Append()
+    self.api:count(self.name .. ":Append")
+    local item = self.factory(#self.items + 1)
+    self.items[#self.items + 1] = item
+    return item
+end
+
+-- ================================
+-- STAND-IN
+-- ================================
+
+-- Wing model for one WINGS entry: XKey count and which XKeys have encoders, like the firmware built for it
+local function newWingModel(api, spec)
+    local model = {
+        keys = 0,
+        encoderKeys = {},       -- [encoder] = xkey
+        hasEncoder = {},        -- [xkey] = true
+        page = api.page,
+        writePage = nil,        -- Channel 3 CC 2 write page (prefetch)
+        pages = {},             -- Wing page cache: [page][xkey] = {status =, r =, g =, b =, fader =}
+    }
+    for _, range in ipairs(spec.ranges or {}) do
+        for _ = range.first, range.last do
+            model.keys = model.keys + 1
+            if range.encoders then
+                model.encoderKeys[#model.encoderKeys + 1] = model.keys
+                model.hasEncoder[model.keys] = true
+            end
+        end
+    end
+    model.groupKeys = math.ceil(model.keys / 4)
+    return model
+end
+
+-- show = {
+--     sequences = {[no] = {name =, color = {r, g, b}, on =, fader =}},
+--     pages = {[page] = {[execNum] = sequenceNo}},
+--     startPage = 1,
+--     wing = {credits = 120}, -- optional wing model answering credit, page digest and ping requests through the link remotes
+--     wings = {...}           -- optional WINGS list for the plugin (EvoCmdWingWings), one wing model per channel block
+-- }
+function StandIn.new(show)
+    local api = setmetatable({
+        show = show,
+        time = 0,               -- Simulated seconds
+        page = show.startPage or 1,
+        calls = {},             -- [api name] = count
+        midi = {},              -- Emitted SendMIDI: {time =, channel =, cc =, value =}
+        printed = {},
+        quiet = false,
+        cmdLines = 0,           -- Cmd() calls
+        cmdCommands = 0,        -- Commands inside them (';' separated)
+        wingModels = {},        -- [channelBase] = wing model, see newWingModel()
+        handles = {},           -- [page * 1000 + execNum] = executor handle
+        pageInfo = {no = show.startPage or 1}, -- CurrentExecPage() result
+        midiSink = nil,         -- Optional function(channel, cc, value) for every SendMIDI
+    }, StandIn)
+
+    api.sequences = {}
+    for no, spec in pairs(show.sequences or {}) do
+        api.sequences[no] = newSequence(api, no, spec)
+    end
+    api.sequencePool = newPool(api, "Sequences", function(n)
+        local no = 10000 + n
+        local seq = newSequence(api, no, {})
+        api.sequences[no] = seq
+        return seq
+    end)
+    for no, seq in pairs(api.sequences) do
+        api.sequencePool.items[#api.sequencePool.items + 1] = seq
+    end
+
+    api.remotePool = newPool(api, "MIDIRemotes", function(n)
+        return setmetatable({no = n, name = "", key = "", fader = ""}, Remote)
+    end)
+
+    -- Without show.wings the plugin runs its default single wing: 16 XKeys, encoders on XKeys 1-8
+    for _, spec in ipairs(show.wings or {{ranges = {{first = 1, last = 8, encoders = true}, {first = 9, last = 16}}}}) do
+        local base = spec.channelBase or 0
+        api.wingModels[base] = newWingModel(api, spec)
+    end
+    return api
+end
+
+function StandIn:count(name)
+    self.calls[name] = (self.calls[name] or 0) + 1
+end
+
+function StandIn:executorHandle(page, execNum)
+    local id = page * 1000 + execNum
+    local exec = self.handles[id]
+    if not exec then
+        exec = setmetatable({api = self, page = page, no = execNum}, Executor)
+        exec.list = {exec} -- ObjectList() result
+        self.handles[id] = exec
+    end
+    return exec
+end
+
+function StandIn:assignedSequence(page, execNum)
+    local assignments = self.show.pages and self.show.pages[page]
+    local seqNo = assignments and assignments[execNum]
+    return seqNo and self.sequences[seqNo] or nil
+end
+
+-- ================================
+-- SCRIPTED PLAYBACK CHANGES
+-- ================================
+-- {action = "page", page =} | {action = "on"/"off"/"toggle", sequence =} | {action = "fader", sequence =, value =}
+-- {action = "color", sequence =, color = {r, g, b}} | {action = "assign", page =, exec =, sequence = (nil clears)}
+-- {action = "midi", channel =, cc =, value =} (wing → desk, e.g. an XKey encoder turn)
+-- {action = "wingReset"} (the wings restart with an empty page cache)
+function StandIn:apply(event)
+    local seq = event.sequence and self.sequences[event.sequence]
+    if event.action == "page" then
+        self.page = event.page
+    elseif event.action == "on" and seq then
+        seq.active = true
+    elseif event.action == "off" and seq then
+        seq.active = false
+    elseif event.action == "toggle" and seq then
+        seq.active = not seq.active
+    elseif event.action == "fader" and seq then
+        seq.faders.FaderMaster = event.value
+    elseif event.action == "color" and seq then
+        seq.APPEARANCE.BACKR, seq.APPEARANCE.BACKG, seq.APPEARANCE.BACKB = event.color[1], event.color[2], event.color[3]
+    elseif event.action == "midi" then
+        -- Encoder turns are kept in the wing's page cache too
+        local model = self.wingModels[event.channel - 1]
+        local xkey = model and model.encoderKeys[event.cc - 5]
+        if xkey then
+            self:wingKey(model, model.page, xkey).fader = event.value
+        end
+        self:receiveMidi(event.channel, event.cc, event.value)
+    elseif event.action == "wingReset" then
+        for _, model in pairs(self.wingModels) do
+            model.pages = {}
+            model.page = 1
+            model.writePage = nil
+        end
+    elseif event.action == "assign" then
+        self.show.pages[event.page] = self.show.pages[event.page] or {}
+        self.show.pages[event.page][event.exec] = event.sequence
+    else
+        error("Unknown show event: " .. tostring(event.action))
+    end
+end
+
+-- ================================
+-- MIDI
+-- ================================
+
+-- MIDI arriving at the desk: remotes with a target and fader move that fader (0-127 → 0-100%)
+function StandIn:receiveMidi(channel, cc, value)
+    for _, remote in ipairs(self.remotePool.items) do
+        if remote.target and tonumber(remote.midichannel) == channel and tonumber(remote.midiindex) == cc
+            and tonumber(remote.miditype) == 3 then
+            local token = FADER_TOKENS[remote.fader] or remote.fader
+            if token and token ~= "" and remote.target.faders then
+                remote.target.faders[token] = value * 100 / 127
+            end
+        end
+    end
+end
+
+function StandIn:wingKey(model, page, xkey)
+    model.pages[page] = model.pages[page] or {}
+    local key = model.pages[page][xkey]
+    if not key then
+        key = {status = 0, r = 0, g = 0, b = 0, fader = nil}
+        model.pages[page][xkey] = key
+    end
+    return key
+end
+
+-- Firmware pageGroupDigest(): status, RGB when populated, fader (128 = none) for XKeys with encoders
+function StandIn:wingDigest(model, page, group)
+    local hash = 1
+    local function add(value)
+        hash = (hash * 31 + value) % 16381
+    end
+    for xkey = (group - 1) * model.groupKeys + 1, math.min(group * model.groupKeys, model.keys) do
+        local key = self:wingKey(model, page, xkey)
+        local populated = key.status == 65 or key.status == 127
+        add(populated and key.status or 0)
+        if populated then
+            add(key.r)
+            add(key.g)
+            add(key.b)
+        end
+        if model.hasEncoder[xkey] then
+            add(key.fader or 128)
+        end
+    end
+    return hash
+end
+
+-- Wing model: answers credit requests (link channel CC 1) with credits and their request number, keeps a page
+-- cache from its first three channels and answers page digest requests (CC 2) and pings (CC 3) like the firmware
+function StandIn:wingModel(channel, cc, value)
+    local wing = self.show.wing
+    local base = math.floor((channel - 1) / 4) * 4
+    local model = self.wingModels[base]
+    if not (wing and model) then
+        return
+    end
+    local link = base + 4
+    local offset = channel - base
+    local keys = model.keys
+    local page = model.writePage or model.page
+    if offset == 4 and cc == 1 then
+        self:receiveMidi(link, 1, wing.credits or 120)
+        self:receiveMidi(link, 2, value)
+    elseif offset == 4 and cc == 2 then
+        for group = 1, 4 do
+            local digest = self:wingDigest(model, model.page, group)
+            self:receiveMidi(link, 3 + group, digest % 128)
+            self:receiveMidi(link, 9 + group, math.floor(digest / 128))
+        end
+        self:receiveMidi(link, 3, value)
+    elseif offset == 4 and cc == 3 then
+        self:receiveMidi(link, 8, 0)
+        self:receiveMidi(link, 9, value)
+    elseif offset == 3 and cc == 1 then
+        model.page = value
+        model.writePage = nil
+    elseif offset == 3 and cc == 2 then
+        model.writePage = value ~= 0 and value or nil
+    elseif offset == 2 and cc >= 1 and cc <= keys then
+        self:wingKey(model, page, cc).status = value
+    elseif offset == 2 and cc > keys and cc <= keys * 4 then
+        local key = self:wingKey(model, page, math.floor((cc - keys - 1) / 3) + 1)
+        local component = ({"r", "g", "b"})[(cc - keys - 1) % 3 + 1]
+        key[component] = value
+    elseif offset == 1 and model.encoderKeys[cc - 5] then
+        self:wingKey(model, page, model.encoderKeys[cc - 5]).fader = value
+    end
+end
+
+function StandIn:sendMidi(kind, channel, cc, value)
+    self.midi[#self.midi + 1] = {time = self.time, kind = kind, channel = channel, cc = cc, value = value}
+    if self.midiSink then
+        self.midiSink(channel, cc, value)
+    end
+    self:wingModel(channel, cc, value)
+end
+
+-- ================================
+-- COMMAND LINE
+-- ================================
+
+function StandIn:findByAddr(addr)
+    local kind, no = addr:match("^(%a+) (%d+)$")
+    no = tonumber(no)
+    if kind == "MIDIRemote" then
+        return self.remotePool.items[no]
+    elseif kind == "Sequence" then
+        return self.sequences[no]
+    end
+    return nil
+end
+
+function StandIn:runCommand(command)
+    command = command:match("^%s*(.-)%s*$")
+    if command == "" then
+        return
+    end
+
+    local kind, channel, cc, value = command:match('^SendMIDI "(%a+)" (%d+)/(%d+) (%d+)$')
+    if kind then
+        self:sendMidi(kind, tonumber(channel), tonumber(cc), tonumber(value))
+        return
+    end
+
+    local addr, prop, rest = command:match('^Set (%a+ %d+) Property "(%w+)" (.*)$')
+    if addr then
+        local obj = self:findByAddr(addr)
+        if not obj then
+            error("Cmd: no object at " .. addr)
+        end
+        local text = rest:match('^"(.*)"$')
+        local key = prop:lower()
+        if key == "target" then
+            obj.target = (text == nil or text == "") and nil or self:findByAddr(text)
+        else
+            obj[key] = text or tonumber(rest) or rest
+        end
+        return
+    end
+
+    error("Cmd: unsupported command '" .. command .. "'")
+end
+
+-- ================================
+-- API ENVIRONMENT
+-- ================================
+
+-- Globals the plugin sees, plus the plugin's own standard library access
+function StandIn:environment()
+    local api = self
+    local env = setmetatable({}, {__index = _G})
+    env.EvoCmdWingWings = api.show.wings
+
+    env.GetExecutor = function(execNum)
+        api:count("GetExecutor")
+        return api:executorHandle(api.page, execNum), api.page
+    end
+
+    env.CurrentExecPage = function()
+        api:count("CurrentExecPage")
+        if api.onCycle then
+            api.onCycle()
+        end
+        api.pageInfo.no = api.page
+        return api.pageInfo
+    end
+
+    env.ObjectList = function(query)
+        api:count("ObjectList")
+        local page, execNum = query:lower():match("^page (%d+)%.(%d+)$")
+        if page then
+            -- Executor handle of any page, like GetExecutor's (the fader property is there too)
+            return api:executorHandle(tonumber(page), tonumber(execNum)).list
+        end
+        local seqName = query:match('^Sequence "(.*)"$')
+        if seqName then
+            for _, seq in pairs(api.sequences) do
+                if seq.name == seqName then
+                    return {seq}
+                end
+            end
+        end
+        return {}
+    end
+
+    env.Root = function()
+        api:count("Root")
+        return {ShowData = {Remotes = {MIDIRemotes = api.remotePool}}}
+    end
+
+    env.DataPool = function()
+        api:count("DataPool")
+        return {Sequences = api.sequencePool}
+    end
+
+    env.Cmd = function(line)
+        api:count("Cmd")
+        api.cmdLines = api.cmdLines + 1
+        for command in (line .. ";"):gmatch("([^;]*);") do
+            if command:match("%S") then
+                api.cmdCommands = api.cmdCommands + 1
+                api:runCommand(command)
+            end
+        end
+    end
+
+    env.Printf = function(fmt, ...)
+        api:count("Printf")
+        local text = string.format(fmt, ...)
+        api.printed[#api.printed + 1] = text
+        if not api.quiet then
+            print(string.format("[%8.3f] %s", api.time, text))
+        end
+    end
+
+    env.Time = function()
+        return api.time
+    end
+
+    env.GetFocusDisplay = function()
+        return nil
+    end
+
+    -- Menus pick the scripted answer (Start by default)
+    env.PopupInput = function(desc)
+        api:count("PopupInput")
+        local answer = api.popupAnswer or "Start"
+        for i, item in ipairs(desc.items) do
+            if item == answer then
+                return i, item
+            end
+        end
+        return nil, nil
+    end
+
+    return env
+end
+
+return StandIn
@@ -0,0 +1,263 @@
+-- EvoCmdWingMidi offline - plugin runner
+-- Runs evocmdwingmidi_main.lua against the grandMA3 stand-in on a simulated clock and reports
+-- per-cycle CPU time, Lua allocation, API-call counts and emitted MIDI
+--
+-- Usage (from the repo root):
+--     lua lua/offline/run_plugin.lua [show.lua] [options]
+--         --cycles N        Stop after N plugin cycles (default: the show's duration)
+--         --plugin PATH     Plugin to run (default lua/evocmdwingmidi_main.lua)
+--         --no-remotes      Don't run Create MIDI Remotes first (no wing link, fixed pacing)
+--         --debug           Turn on the plugin's debug mode
+--         --verbose         Show the plugin's Printf output
+--         --midi            List every emitted MIDI message
+--         --midi-out PATH   Write emitted MIDI as raw bytes (e.g. a FIFO piped into the native build's socket)
+
+local scriptDir = (arg and arg[0] or ""):match("^(.*)[/\\]") or "."
+package.path = scriptDir .. "/?.lua;" .. package.path
+
+local StandIn = require("ma3_standin")
+
+-- ================================
+-- OPTIONS
+-- ================================
+
+local options = {
+    show = scriptDir .. "/example_show.lua",
+    plugin = scriptDir .. "/../evocmdwingmidi_main.lua",
+    cycles = nil,
+    remotes = true,
+    debug = false,
+    verbose = false,
+    listMidi = false,
+    midiOut = nil,
+}
+
+local i = 1
+while arg and arg[i] do
+    local a = arg[i]
+    if a == "--cycles" then
+        i = i + 1
+        options.cycles = tonumber(arg[i])
+    elseif a == "--plugin" then
+        i = i + 1
+        options.plugin = arg[i]
+    elseif a == "--no-remotes" then
+        options.remotes = false
+    elseif a == "--debug" then
+        options.debug = true
+    elseif a == "--verbose" then
+        options.verbose = true
+    elseif a == "--midi" then
+        options.listMidi = true
+    elseif a == "--midi-out" then
+        i = i + 1
+        options.midiOut = arg[i]
+    elseif a:sub(1, 2) == "--" then
+        error("Unknown option " .. a)
+    else
+        options.show = a
+    end
+    i = i + 1
+end
+
+local show = dofile(options.show)
+local api = StandIn.new(show)
+api.quiet = not options.verbose
+
+if options.midiOut then
+    local out = assert(io.open(options.midiOut, "wb"))
+    api.midiSink = function(channel, cc, value)
+        out:write(string.char(0xB0 + channel - 1, cc, value))
+        out:flush()
+    end
+end
+
+-- ================================
+-- PLUGIN
+-- ================================
+
+local env = api:environment()
+local chunk
+if setfenv then
+    chunk = assert(loadfile(options.plugin))
+    setfenv(chunk, env)
+else
+    chunk = assert(loadfile(options.plugin, "t", env))
+end
+local main = chunk("EvoCmdWingMidi", "evocmdwingmidi_main", {}, nil)
+
+-- Menu answers for the next main() call, consumed in order
+local function runMenu(...)
+    local answers = {...}
+    local env_PopupInput = env.PopupInput
+    env.PopupInput = function(desc)
+        local answer = table.remove(answers, 1) or "Start"
+        for idx, item in ipairs(desc.items) do
+            if item:sub(1, #answer) == answer then
+                api:count("PopupInput")
+                return idx, item
+            end
+        end
+        return nil, nil
+    end
+    return function()
+        env.PopupInput = env_PopupInput
+    end
+end
+
+if options.remotes then
+    local restore = runMenu("Create MIDI Remotes", "Toggle")
+    main()
+    restore()
+end
+if options.debug then
+    local restore = runMenu("Debug")
+    main()
+    restore()
+end
+
+-- ================================
+-- CYCLE ACCOUNTING
+-- ================================
+
+local cycles = {}            -- {cpu =, simTime =, calls =, midi =, cmd =, alloc =}
+local current = nil
+local segmentStart = 0
+local callTotal = 0
+
+local function totalCalls()
+    local n = 0
+    for _, count in pairs(api.calls) do
+        n = n + count
+    end
+    return n
+end
+
+local function closeCycle(now)
+    if current then
+        -- First, before the accounting below allocates anything (the GC is stopped during the run)
+        current.alloc = collectgarbage("count") - current.startKB
+        current.cpu = current.cpu + (now - segmentStart)
+        current.simTime = api.time - current.startTime
+        current.calls = totalCalls() - current.startCalls
+        current.midi = #api.midi - current.startMidi
+        current.cmd = api.cmdLines - current.startCmd
+        cycles[#cycles + 1] = current
+    end
+end
+
+-- Called from CurrentExecPage(), the first thing the plugin loop does every cycle
+api.onCycle = function()
+    local now = os.clock()
+    closeCycle(now)
+    current = {cpu = 0, startTime = api.time, startCalls = totalCalls(), startMidi = #api.midi, startCmd = api.cmdLines}
+    current.startKB = collectgarbage("count")
+    segmentStart = now
+end
+
+-- ================================
+-- RUN
+-- ================================
+
+local events = show.events or {}
+table.sort(events, function(a, b) return a.t < b.t end)
+local nextEvent = 1
+local duration = show.duration or 10
+local setupCalls = totalCalls()
+local setupMidi = #api.midi
+
+local plugin = coroutine.create(main)
+local restore = runMenu("Start")
+
+-- Heap growth per cycle is what the cycle allocated (includes the stand-in's MIDI and Printf records)
+collectgarbage("collect")
+collectgarbage("stop")
+
+while coroutine.status(plugin) ~= "dead" do
+    while events[nextEvent] and events[nextEvent].t <= api.time do
+        api:apply(events[nextEvent])
+        nextEvent = nextEvent + 1
+    end
+
+    segmentStart = os.clock()
+    local ok, delay = coroutine.resume(plugin)
+    if current then
+        current.cpu = current.cpu + (os.clock() - segmentStart)
+    end
+    if not ok then
+        error("Plugin error: " .. tostring(delay))
+    end
+    restore()
+
+    api.time = api.time + (tonumber(delay) or 0)
+    if options.cycles and #cycles >= options.cycles then
+        break
+    end
+    if not options.cycles and api.time >= duration then
+        break
+    end
+end
+closeCycle(os.clock())
+collectgarbage("restart")
+
+-- ================================
+-- REPORT
+-- ================================
+
+local function summary(field, scale)
+    local values = {}
+    local sum = 0
+    for idx, c in ipairs(cycles) do
+        values[idx] = c[field] * scale
+        sum = sum + values[idx]
+    end
+    table.sort(values)
+    local n = #values
+    if n == 0 then
+        return 0, 0, 0, 0
+    end
+    return sum / n, values[math.max(1, math.floor(n * 0.5 + 0.5))], values[math.max(1, math.floor(n * 0.95 + 0.5))], values[n]
+end
+
+local function printSummary(label, field, scale, unit)
+    local mean, median, p95, max = summary(field, scale)
+    print(string.format("  %-18s mean %9.3f  median %9.3f  p95 %9.3f  max %9.3f %s", label, mean, median, p95, max, unit))
+end
+
+print(string.format("=== EvoCmdWingMidi offline run: %s ===", options.show))
+print(string.format("Simulated %.2fs, %d cycles, %d show events applied", api.time, #cycles, nextEvent - 1))
+print("Per cycle:")
+printSummary("CPU time", "cpu", 1000, "ms")
+printSummary("Cycle length", "simTime", 1000, "ms (simulated, includes credit waits)")
+printSummary("API calls", "calls", 1, "")
+printSummary("MIDI messages", "midi", 1, "")
+printSummary("Cmd() calls", "cmd", 1, "")
+printSummary("Lua allocation", "alloc", 1, "KB")
+
+print(string.format("API calls (setup %d, total %d):", setupCalls, totalCalls()))
+local names = {}
+for name in pairs(api.calls) do
+    names[#names + 1] = name
+end
+table.sort(names, function(a, b) return api.calls[a] > api.calls[b] end)
+for _, name in ipairs(names) do
+    print(string.format("  %-28s %8d  (%.1f per cycle)", name, api.calls[name], api.calls[name] / math.max(1, #cycles)))
+end
+
+local byChannel = {}
+for _, m in ipairs(api.midi) do
+    byChannel[m.channel] = (byChannel[m.channel] or 0) + 1
+end
+print(string.format("MIDI: %d messages in %d Cmd() calls (%d commands), %d during setup",
+    #api.midi, api.cmdLines, api.cmdCommands, setupMidi))
+for channel = 1, 16 do
+    if byChannel[channel] then
+        print(string.format("  Channel %-2d %8d", channel, byChannel[channel]))
+    end
+end
+
+if options.listMidi then
+    for _, m in ipairs(api.midi) do
+        print(string.format("  %8.3f  ch%-2d %s %3d = %3d", m.time, m.channel, m.kind, m.cc, m.value))
+    end
+end
@@ -1,5 +1,7 @@
 #include "eepromStorage.h"
+#include "config.h"
 #include "utils.h"
+#include "watchdog.h"
 #include <EEPROM.h>
 
 // ================================
@@ -8,12 +10,14 @@
 
 const ConfigData defaultConfig = {
   .signature = CONFIG_SIGNATURE,
-  .version = 1,
+  .version = 3,
   .relativeEncoderSensitivity = 5,
   .absoluteEncoderSensitivity = 5,
   .onBrightness = 1.0f,
   .offBrightness = 0.05f,
-  .logoBrightness = 1.0f
+  .logoBrightness = 1.0f,
+  .faderLevelDisplay = 0,
+  .midiChannelBase = 0
 };
 
 // Global config instance
@@ -49,39 +53,68 @@ bool loadConfig() {
     return false;
   }
   
+  // Older versions are the current one without the fields added at the end, keep their settings,
+  // default the new fields and save the result as the current version
+  bool migrated = false;
+  if (config.version == 1) {
+    config.faderLevelDisplay = FADER_LEVEL_OFF;
+    config.version = 2;
+    migrated = true;
+    debugPrint("[EEPROM] Migrating version 1 config to version 2");
+  }
+  if (config.version == 2) {
+    config.midiChannelBase = 0;
+    config.version = 3;
+    migrated = true;
+    debugPrint("[EEPROM] Migrating version 2 config to version 3");
+  }
+  
   // Validate version (for future compatibility)
   if (config.version != defaultConfig.version) {
     debugPrintf("[EEPROM] Version mismatch: %d (expected %d)", config.version, defaultConfig.version);
     return false;
   }
   
-  // Validate ranges for safety
-  if (config.relativeEncoderSensitivity < 1 || config.relativeEncoderSensitivity > 8) {
+  // Validate ranges for safety, written so a NaN float fails too
+  if (!(config.relativeEncoderSensitivity >= 1 && config.relativeEncoderSensitivity <= 8)) {
     debugPrintf("[EEPROM] Invalid relativeEncoderSensitivity: %d", config.relativeEncoderSensitivity);
     return false;
   }
   
-  if (config.absoluteEncoderSensitivity < 1 || config.absoluteEncoderSensitivity > 8) {
+  if (!(config.absoluteEncoderSensitivity >= 1 && config.absoluteEncoderSensitivity <= 8)) {
     debugPrintf("[EEPROM] Invalid absoluteEncoderSensitivity: %d", config.absoluteEncoderSensitivity);
     return false;
   }
   
-  if (config.onBrightness < 0.0f || config.onBrightness > 1.0f) {
+  if (!(config.onBrightness >= 0.0f && config.onBrightness <= 1.0f)) {
     debugPrintf("[EEPROM] Invalid onBrightness: %.2f", config.onBrightness);
     return false;
   }
   
-  if (config.offBrightness < 0.0f || config.offBrightness > 1.0f) {
+  if (!(config.offBrightness >= 0.0f && config.offBrightness <= 1.0f)) {
     debugPrintf("[EEPROM] Invalid offBrightness: %.2f", config.offBrightness);
     return false;
   }
   
-  if (config.logoBrightness < 0.0f || config.logoBrightness > 1.0f) {
+  if (!(config.logoBrightness >= 0.0f && config.logoBrightness <= 1.0f)) {
     debugPrintf("[EEPROM] Invalid logoBrightness: %.2f", config.logoBrightness);
     return false;
   }
   
+  if (!(config.faderLevelDisplay >= 0 && config.faderLevelDisplay <= 2)) {
+    debugPrintf("[EEPROM] Invalid faderLevelDisplay: %d", config.faderLevelDisplay);
+    return false;
+  }
+  
+  if (!(config.midiChannelBase >= 0 && config.midiChannelBase <= 12)) {
+    debugPrintf("[EEPROM] Invalid midiChannelBase: %d", config.midiChannelBase);
+    return false;
+  }
+  
   debugPrint("[EEPROM] Configuration validation passed");
+  if (migrated) {
+    saveConfig();
+  }
   return true;
 }
 
@@ -90,8 +123,10 @@ void saveConfig() {
   config.signature = CONFIG_SIGNATURE;
   config.version = defaultConfig.version;
   
-  // Write the entire struct to EEPROM
+  // Write the entire struct to EEPROM, timed on its own since a flash erase can take a while
+  LoopSubsystem previous = markSubsystem(SUBSYSTEM_EEPROM);
   EEPROM.put(0, config);
+  markSubsystem(previous);
   
   debugPrint("[EEPROM] Configuration saved");
   printConfig();
@@ -111,4 +146,6 @@ void printConfig() {
   debugPrintf("  On Brightness: %.2f", config.onBrightness);
   debugPrintf("  Off Brightness: %.2f", config.offBrightness);
   debugPrintf("  Logo Brightness: %.2f", config.logoBrightness);
+  debugPrintf("  Fader Level Display: %d", config.faderLevelDisplay);
+  debugPrintf("  MIDI Channel Base: %d (channels %d-%d)", config.midiChannelBase, config.midiChannelBase + 1, config.midiChannelBase + 4);
 }
\ No newline at end of file
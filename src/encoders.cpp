@@ -1,28 +1,16 @@
 #include "encoders.h"
 #include "neopixel.h"
 #include "utils.h"
+#include "flightRecorder.h"
+#include "midi.h"
+#include "power.h"
 #include <MIDIUSB.h>
 
 // ================================
 // ENCODER/BUTTON GLOBAL VARIABLES
 // ================================
 
-// GPIO pins for encoder a/b
-const int ENC_PINS[N_ENCODERS][2] = {
-  {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {11,12}, {14,15},
-  {16,17}, {18,19}, {20,21}, {22,23}, {24,25}, {26,27}
-};
-
-// GPIO pin for encoder click, and inner outter button
-const int BUTTON_PIN[N_BUTTONS] = {
-  28,29,30,31,32,33,34,35,36,37,38,39,40,41
-};
-
-// first 5 are for attribute encoders, next 8 are for XKeys encoders
-const byte ENCODER_NOTES[N_ENCODERS] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
-
-// first 5 for encoders, next 8 for XKeys, last one for inner outter flip
-const byte BUTTON_NOTES[N_BUTTONS] = {1,2,3,4,5,6,7,8,9,10,11,12,13,14};
+// Pins, CCs and notes for encoders and buttons are in the hardware layout (hardware.h)
 
 // Here you can play with the velocity scaling to get the sensitivity you like
 // This works well for me with no accel in Pro Plugins Midi Encoders plugin
@@ -38,7 +26,7 @@ const int VELOCITY_SCALES[8][8] = {
   {3, 4, 5, 6, 7, 8, 10, 10} // Level 8: Very fast
 };
 
-// Array to store current values for encoders 5-12 (absolute mode)
+// Array to store current values for the absolute (XKey) encoders
 int encoderValues[N_ENCODERS] = {0}; // Initialize all to 0
 
 // Note: Encoder sensitivity variables moved to config struct in eeprom.h
@@ -56,7 +44,31 @@ unsigned long lastDebounceTime[N_BUTTONS] = {0};
 unsigned long debounceDelay = 50;  // debounce for encoder buttons
 
 int encoderBuffer[N_ENCODERS] = {0};
-bool midiDataPending = false;
+
+// External fader change received while the encoder was turning, -1 when nothing is held
+static int pendingFeedback[N_ENCODERS];
+
+// Values recently sent by each absolute encoder, feedback matching one of them is an echo
+struct LocalEncoderValue {
+  uint8_t value;
+  unsigned long timeMs;
+};
+static LocalEncoderValue localValues[N_ENCODERS][ENCODER_ECHO_HISTORY];
+static uint8_t localValueNext[N_ENCODERS] = {0};
+static uint8_t localValueCount[N_ENCODERS] = {0};
+
+// Encoders whose value came from the page cache and hasn't been checked against feedback yet
+static bool awaitingFeedback[N_ENCODERS] = {false};
+
+struct EncoderFeedbackStats {
+  unsigned long pageLoads;      // Encoder values taken from the page cache on page change
+  unsigned long confirmed;      // First feedback after the load matched the cached value
+  unsigned long corrected;      // First feedback after the load differed
+  unsigned long echoes;         // Feedback dropped as an echo of a value we sent
+  unsigned long external;       // External changes applied (immediately or after the encoder went idle)
+  unsigned long prefetched;     // Fader values stored for pages that aren't shown
+};
+static EncoderFeedbackStats encoderFeedbackStats = {0, 0, 0, 0, 0, 0};
 
 
 // Adjustment mode (brightness & sensitivity)
@@ -72,15 +84,13 @@ const int ENCODER_FLIP_HOLD_DURATION = 500;   // Time is ms to determin a hold a
 
 void initializeEncoders() {
   for (int i = 0; i < N_ENCODERS; i++) {
-    encoders[i] = new Encoder(ENC_PINS[i][0], ENC_PINS[i][1]);
+    encoders[i] = new Encoder(hw.encoders[i].pinA, hw.encoders[i].pinB);
     lastPos[i] = encoders[i]->read();
-
-    if (i >= 5) {
-      encoderValues[i] = 0;
-    }
+    encoderValues[i] = 0;
+    pendingFeedback[i] = -1;
   }
   for (int i = 0; i < N_BUTTONS; i++) {
-    pinMode(BUTTON_PIN[i], INPUT_PULLUP);
+    pinMode(hw.buttonPins[i], INPUT_PULLUP);
   }
   
   pinMode(LATCH_LED_PIN, OUTPUT);
@@ -88,85 +98,231 @@ void initializeEncoders() {
 }
 
 // Handles encoder moves (every 4 in the same direction) and sends midi output
+// Scan is unrolled at compile time over the layout's encoders
 void handleEncoders() {
 // Buffer the encoder reads to keep from getting bouncing or jumpy readings
-  for (int i = 0; i < N_ENCODERS; i++) {
+  staticFor<N_ENCODERS>([](auto index) {
+    constexpr int i = decltype(index)::value;
     long movement = encoders[i]->readAndReset();
     encoderBuffer[i] += movement;
 
     while (abs(encoderBuffer[i]) >= 4) {
       int dir = (encoderBuffer[i] > 0) ? 1 : -1;
+      recordFlightEvent(FLIGHT_ENCODER, i, (uint8_t)dir, 0);
+      noteInputHandled();
       sendMidiEncoder(i, dir);
       encoderBuffer[i] -= (4 * dir);
     }
+  });
+  
+  serviceEncoderFeedback();
+}
+
+// Keep the current page's cached fader value in step with an absolute encoder
+static inline void storePageEncoderValue(int index) {
+  ExecutorStatus* status = &pageData[currentPage][hw.encoders[index].xkey];
+  status->faderValue = (uint8_t)encoderValues[index];
+  status->hasFaderValue = true;
+}
 
+static void applyEncoderFeedback(int index, int value) {
+  if (awaitingFeedback[index]) {
+    awaitingFeedback[index] = false;
+    if (value == encoderValues[index]) {
+      encoderFeedbackStats.confirmed++;
+    } else {
+      encoderFeedbackStats.corrected++;
+      tracePrintf(TRACE_ENCODER, "[ENCODER] Index: %d | Cached page value %d corrected to %d", index, encoderValues[index], value);
+    }
   }
+  encoderValues[index] = value;
+  storePageEncoderValue(index);
 }
 
-// Handles and sends midi for button presses from encoder and from encoder flip button
-void handleButtons() {
-  for (int i = 0; i < N_BUTTONS; i++) {
-    int reading = digitalRead(BUTTON_PIN[i]);
-
-    if ((millis() - lastDebounceTime[i]) > debounceDelay) {
-      if (reading != buttonPState[i]) {
-        lastDebounceTime[i] = millis();
-        int note = BUTTON_NOTES[i];
-        int velocity;
-        
-        if (i == 13) {
-          if (reading == LOW) {
-            // Button 14 pressed down
-            if (!adjustMode) {
-              // Start tracking hold time for adjustment mode
-              encoderFlipHoldTime = millis();
-              adjustMode = true;
-              debugPrint("[ADJUST] Button 14 held - adjustment mode ON");
-            }
-            velocity = -1; // Don't send MIDI while held
-          } else {
-            // Button 14 released
-            if (adjustMode) {
-              unsigned long holdDuration = millis() - encoderFlipHoldTime;
-              adjustMode = false;
-              sensitivityMode = false;
-              saveConfig();
-              updateXKeyLEDs();
+static void rememberLocalValue(int index, int value) {
+  LocalEncoderValue* entry = &localValues[index][localValueNext[index]];
+  entry->value = (uint8_t)value;
+  entry->timeMs = millis();
+  localValueNext[index] = (localValueNext[index] + 1) % ENCODER_ECHO_HISTORY;
+  if (localValueCount[index] < ENCODER_ECHO_HISTORY) {
+    localValueCount[index]++;
+  }
+}
+
+// The plugin rounds fader percent back to the CC value it came from, so echoes match exactly
+// Echoes come back in the order the values were sent: a match consumes its entry and every older one,
+// so each sent value swallows at most one feedback message and an external change to it gets through
+static bool isLocalEcho(int index, int value, unsigned long now) {
+  int count = localValueCount[index];
+  int oldest = (localValueNext[index] + ENCODER_ECHO_HISTORY - count) % ENCODER_ECHO_HISTORY;
+  for (int n = 0; n < count; n++) {
+    const LocalEncoderValue* entry = &localValues[index][(oldest + n) % ENCODER_ECHO_HISTORY];
+    if (entry->value == value && (now - entry->timeMs) < ENCODER_ECHO_WINDOW_MS) {
+      localValueCount[index] = count - n - 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Fader position feedback from the plugin for absolute (XKey) encoders
+// Echoes of values we sent are dropped, so a stale echo can't pull the value back mid turn.
+// External changes are applied right away when the encoder is idle, otherwise held until it is
+void setEncoderFeedback(int index, int value) {
+  if (index < 0 || index >= N_ENCODERS || hw.encoders[index].role != ENCODER_ABSOLUTE) return;
+  
+  value = constrain(value, 0, 127);
+  unsigned long now = millis();
+  
+  if (isLocalEcho(index, value, now)) {
+    encoderFeedbackStats.echoes++;
+    return;
+  }
+  
+  if (value == encoderValues[index]) {
+    // Already there (fader sync after a page change), anything held is out of date
+    pendingFeedback[index] = -1;
+    applyEncoderFeedback(index, value);
+    return;
+  }
+  
+  if ((now - lastMoveTime[index]) < ENCODER_FEEDBACK_HOLDOFF_MS) {
+    pendingFeedback[index] = value;
+    return;
+  }
+  
+  pendingFeedback[index] = -1;
+  encoderFeedbackStats.external++;
+  applyEncoderFeedback(index, value);
+}
+
+// Apply held feedback once its encoder has stopped moving
+void serviceEncoderFeedback() {
+  unsigned long now = millis();
+  staticFor<N_ENCODERS>([now](auto index) {
+    constexpr int i = decltype(index)::value;
+    if (Hardware::encoder(i).role != ENCODER_ABSOLUTE) return;
+    
+    if (pendingFeedback[i] >= 0 && (now - lastMoveTime[i]) >= ENCODER_FEEDBACK_HOLDOFF_MS) {
+      tracePrintf(TRACE_ENCODER, "[ENCODER] Index: %d | Applying held feedback: %d (was %d)", i, pendingFeedback[i], encoderValues[i]);
+      encoderFeedbackStats.external++;
+      applyEncoderFeedback(i, pendingFeedback[i]);
+      pendingFeedback[i] = -1;
+    }
+  });
+}
+
+// Called from handlePageMIDI() after currentPage changed, so a turn before the plugin's fader sync
+// starts from the new page's value instead of the old page's
+void loadPageEncoderValues() {
+  staticFor<N_ENCODERS>([](auto index) {
+    constexpr int i = decltype(index)::value;
+    if (Hardware::encoder(i).role != ENCODER_ABSOLUTE) return;
+    
+    // Feedback held and values sent for the old page no longer apply
+    pendingFeedback[i] = -1;
+    localValueCount[i] = 0;
+    
+    const ExecutorStatus* status = &pageData[currentPage][Hardware::encoder(i).xkey];
+    if (status->hasFaderValue) {
+      encoderValues[i] = status->faderValue;
+      awaitingFeedback[i] = true;
+      encoderFeedbackStats.pageLoads++;
+    } else {
+      // Page not seen yet, keep the value until the plugin's sync arrives
+      awaitingFeedback[i] = false;
+    }
+  });
+}
+
+// Prefetched fader value, it only matters once the page is loaded so the encoder isn't touched
+void storeBackgroundEncoderValue(int page, int index, int value) {
+  if (hw.encoders[index].role != ENCODER_ABSOLUTE) {
+    return;
+  }
+  ExecutorStatus* status = &pageData[page][hw.encoders[index].xkey];
+  status->faderValue = (uint8_t)value;
+  status->hasFaderValue = true;
+  encoderFeedbackStats.prefetched++;
+}
+
+void printEncoderStats() {
+  Serial.printf("[ENCODER STATS] Page cache loads: %lu | Confirmed by feedback: %lu | Corrected: %lu\n",
+                encoderFeedbackStats.pageLoads, encoderFeedbackStats.confirmed, encoderFeedbackStats.corrected);
+  Serial.printf("[ENCODER STATS] Echoes suppressed: %lu | External changes applied: %lu | Prefetched page values: %lu\n",
+                encoderFeedbackStats.echoes, encoderFeedbackStats.external, encoderFeedbackStats.prefetched);
+}
+
+// Handles one button reading, i is the button index (encoder clicks, then the flip button)
+static void handleButton(int i, int reading) {
+  if ((millis() - lastDebounceTime[i]) > debounceDelay) {
+    if (reading != buttonPState[i]) {
+      lastDebounceTime[i] = millis();
+      recordFlightEvent(FLIGHT_BUTTON, i, reading == LOW, 0);
+      noteInputHandled();
+      int note = hw.buttonNotes[i];
+      int velocity;
+      
+      if (i == FLIP_BUTTON_INDEX) {
+        if (reading == LOW) {
+          // Button 14 pressed down
+          if (!adjustMode) {
+            // Start tracking hold time for adjustment mode
+            encoderFlipHoldTime = millis();
+            adjustMode = true;
+            debugPrint("[ADJUST] Button 14 held - adjustment mode ON");
+          }
+          velocity = -1; // Don't send MIDI while held
+        } else {
+          // Button 14 released
+          if (adjustMode) {
+            unsigned long holdDuration = millis() - encoderFlipHoldTime;
+            adjustMode = false;
+            sensitivityMode = false;
+            saveConfig();
+            updateXKeyLEDs();
+            
+            // Only toggle latch if it was a quick press (less than 500ms)
+            if (holdDuration < ENCODER_FLIP_HOLD_DURATION) {
+              latchButtonState = !latchButtonState;
+              velocity = latchButtonState ? 127 : 0;
+              digitalWrite(LATCH_LED_PIN, latchButtonState ? HIGH : LOW);
               
-              // Only toggle latch if it was a quick press (less than 500ms)
-              if (holdDuration < ENCODER_FLIP_HOLD_DURATION) {
-                latchButtonState = !latchButtonState;
-                velocity = latchButtonState ? 127 : 0;
-                digitalWrite(LATCH_LED_PIN, latchButtonState ? HIGH : LOW);
-                
-                debugPrintf("[LATCH BUTTON] Quick press - State: %s | LED: %s", 
-                           latchButtonState ? "ON" : "OFF", 
-                           latchButtonState ? "ON" : "OFF");
-              } else {
-                velocity = -1; // Don't send MIDI for long press release
-                debugPrintf("[ADJUST] Button 14 released after %lu ms - adjustment mode OFF", holdDuration);
-              }
+              debugPrintf("[LATCH BUTTON] Quick press - State: %s | LED: %s", 
+                         latchButtonState ? "ON" : "OFF", 
+                         latchButtonState ? "ON" : "OFF");
             } else {
-              velocity = -1;
+              velocity = -1; // Don't send MIDI for long press release
+              debugPrintf("[ADJUST] Button 14 released after %lu ms - adjustment mode OFF", holdDuration);
             }
+          } else {
+            velocity = -1;
           }
-        } else {
-          velocity = (reading == LOW) ? 1 : 0;
-        }
-        
-        if (velocity != -1) {
-          usbMIDI.sendNoteOn(note, velocity, midiCh, 0);
-          midiDataPending = true;
-
-          debugPrintf("[MIDI OUT] Button %d → Note: %d | Vel: %d | Ch: %d", i, note, velocity, midiCh);
         }
+      } else {
+        velocity = (reading == LOW) ? 1 : 0;
+      }
+      
+      if (velocity != -1) {
+        queueNoteOn(note, velocity, wingToMidiChannel(midiCh));
 
-        buttonPState[i] = reading;
+        tracePrintf(TRACE_BUTTON, "[MIDI OUT] Button %d → Note: %d | Vel: %d | Ch: %d", i, note, velocity, wingToMidiChannel(midiCh));
       }
+
+      buttonPState[i] = reading;
     }
   }
 }
 
+// Handles and sends midi for button presses from encoder and from encoder flip button
+// Unrolled over the layout's buttons, so every read is a constant pin digitalReadFast()
+void handleButtons() {
+  staticFor<N_BUTTONS>([](auto index) {
+    constexpr int i = decltype(index)::value;
+    handleButton(i, digitalReadFast(layoutButtonPin<Hardware>(i)));
+  });
+}
+
 // setup for midi mode 3, can change to 2's comp mode 1 if needed
 // Using grandma3 plugin MidiEncoders from ProPlugins
 void sendMidiEncoder(int index, int direction) {
@@ -175,13 +331,15 @@ void sendMidiEncoder(int index, int direction) {
   if (elapsed < 5) return;  // Skip if less than 5ms since last move, keep from dumping buffer all at once issue we sometimes have got
   lastMoveTime[index] = now;
 
-  // Special handling for encoders 5, 6, 11, 12 and 13 when button 14 is held (brightness/sensitivity adjustment)
-  if ((index == 4 || index == 5 || index == 10 || index == 11 || index == 12) && adjustMode) {
+  const EncoderSpec& spec = hw.encoders[index];
+
+  // Special handling for the layout's adjust encoders (V0.2: 5, 6, 11, 12 and 13) when the flip button is held (brightness/sensitivity adjustment)
+  if (spec.adjust != ADJUST_NONE && adjustMode) {
     // Calculate step size using same velocity scaling as normal encoders
     int level = constrain((int)(elapsed / 15), 0, 7);
     int baseStep = VELOCITY_SCALES[4][7 - level]; // Use level 5 scale for consistent adjustment speed
     
-    if (index == 4) {
+    if (spec.adjust == ADJUST_RELATIVE_SENSITIVITY) {
       // Encoder 5 controls relativeEncoderSensitivity
       sensitivityMode = true;  // Block normal LED updates
       int step = (baseStep > 3) ? 1 : 1; // Always step by 1 for sensitivity settings
@@ -193,7 +351,7 @@ void sendMidiEncoder(int index, int direction) {
       updateSensitivityLEDs();
       debugPrintf("[RELATIVE SENSITIVITY] Encoder 5 → Level: %d", config.relativeEncoderSensitivity);
       
-    } else if (index == 5) {
+    } else if (spec.adjust == ADJUST_ABSOLUTE_SENSITIVITY) {
       // Encoder 6 controls absoluteEncoderSensitivity  
       sensitivityMode = true;  // Block normal LED updates
       int step = (baseStep > 3) ? 1 : 1; // Always step by 1 for sensitivity settings
@@ -205,7 +363,7 @@ void sendMidiEncoder(int index, int direction) {
       updateSensitivityLEDs();
       debugPrintf("[ABSOLUTE SENSITIVITY] Encoder 6 → Level: %d", config.absoluteEncoderSensitivity);
       
-    } else if (index == 10) {
+    } else if (spec.adjust == ADJUST_LOGO_BRIGHTNESS) {
       // Encoder 11 controls logoBrightness
       sensitivityMode = false;  // Allow normal LED updates for brightness adjustment
       float step = baseStep * 0.01f;  // Convert to 0.01 increments (1% steps)
@@ -218,7 +376,7 @@ void sendMidiEncoder(int index, int direction) {
       debugPrintf("[BRIGHTNESS] Encoder 11 → Dir: %s | Logo brightness: %.2f | Step: %.2f", 
                  direction > 0 ? "+" : "-", config.logoBrightness, step);
 
-    } else if (index == 11) {
+    } else if (spec.adjust == ADJUST_OFF_BRIGHTNESS) {
       // Encoder 12 controls offBrightness (populated but off state)
       sensitivityMode = false;  // Allow normal LED updates for brightness adjustment
       float step = baseStep * 0.01f;  // Convert to 0.01 increments (1% steps)
@@ -231,7 +389,7 @@ void sendMidiEncoder(int index, int direction) {
       debugPrintf("[BRIGHTNESS] Encoder 12 → Dir: %s | Off brightness: %.2f | Step: %.2f", 
                  direction > 0 ? "+" : "-", config.offBrightness, step);
 
-    } else if (index == 12) {
+    } else if (spec.adjust == ADJUST_ON_BRIGHTNESS) {
       // Encoder 13 controls onBrightness (populated and on state)
       sensitivityMode = false;  // Allow normal LED updates for brightness adjustment
       float step = baseStep * 0.01f;  // Convert to 0.01 increments (1% steps)
@@ -253,16 +411,17 @@ void sendMidiEncoder(int index, int direction) {
 
   // Get the appropriate velocity scale for current encoder type
   const int* currentScale;
-  if (index < 5) {
-    // Relative encoders (0-4): use relative sensitivity
+  bool relative = (spec.role == ENCODER_RELATIVE);
+  if (relative) {
+    // Relative (attribute) encoders: use relative sensitivity
     currentScale = VELOCITY_SCALES[config.relativeEncoderSensitivity - 1];
   } else {
-    // Absolute encoders (5-12): use absolute sensitivity  
+    // Absolute (XKey) encoders: use absolute sensitivity  
     currentScale = VELOCITY_SCALES[config.absoluteEncoderSensitivity - 1];
   }
 
-  if (index < 5) {
-    // First 5 encoders: velocity-based mode for plugin
+  if (relative) {
+    // Attribute encoders: velocity-based mode for plugin
     int level = constrain((int)(elapsed / 15), 0, 7);
     int scaled = currentScale[7 - level];  // fast = high index = smaller scaled value
 
@@ -272,7 +431,7 @@ void sendMidiEncoder(int index, int direction) {
       final_value = 64 + scaled ; // left 65 and up
     }
   } else {
-    // Encoders 5-12: absolute value mode (0-127)
+    // XKey encoders: absolute value mode (0-127)
     int level = constrain((int)(elapsed / 15), 0, 7);
     int step = currentScale[7 - level];  // Use sensitivity-specific velocity scaling for step size
     
@@ -283,16 +442,24 @@ void sendMidiEncoder(int index, int direction) {
     }
     
     final_value = encoderValues[index];
+    storePageEncoderValue(index);
+    rememberLocalValue(index, final_value);
+    
+    // Shown on the XKey right away, grandMA3's feedback only confirms it
+    showFaderLevel(spec.xkey, final_value);
   }
 
-  usbMIDI.sendControlChange(ENCODER_NOTES[index], final_value, midiCh, 0);
-  midiDataPending = true;
+  if (relative) {
+    queueRelativeCC(spec.cc, final_value, wingToMidiChannel(midiCh));
+  } else {
+    queueAbsoluteCC(spec.cc, final_value, wingToMidiChannel(midiCh));
+  }
 
-  if (index >= 5) {
-    debugPrintf("[ENCODER] Index: %d | Dir: %s | CC: %d | Value Sent: %d | Stored: %d | Elapsed: %lu ms", 
-               index, direction > 0 ? "+" : "-", ENCODER_NOTES[index], final_value, encoderValues[index], elapsed);
+  if (!relative) {
+    tracePrintf(TRACE_ENCODER, "[ENCODER] Index: %d | Dir: %s | CC: %d | Value Sent: %d | Stored: %d | Elapsed: %lu ms", 
+               index, direction > 0 ? "+" : "-", spec.cc, final_value, encoderValues[index], elapsed);
   } else {
-    debugPrintf("[ENCODER] Index: %d | Dir: %s | CC: %d | Value Sent: %d | Elapsed: %lu ms", 
-               index, direction > 0 ? "+" : "-", ENCODER_NOTES[index], final_value, elapsed);
+    tracePrintf(TRACE_ENCODER, "[ENCODER] Index: %d | Dir: %s | CC: %d | Value Sent: %d | Elapsed: %lu ms", 
+               index, direction > 0 ? "+" : "-", spec.cc, final_value, elapsed);
   }
 }
\ No newline at end of file
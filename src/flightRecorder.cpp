@@ -0,0 +1,92 @@
+#include "flightRecorder.h"
+#include "utils.h"
+
+// ================================
+// FLIGHT RECORDER
+// ================================
+
+FlightRecord flightRecords[FLIGHT_RECORDER_SIZE];
+uint32_t flightRecordCount = 0;
+bool flightRecorderPaused = false;
+
+// Dump format (little endian), decoded by tools/flight_recorder_decode.py:
+//   "EVFR", uint8 version, uint8 record size, uint16 capacity,
+//   uint32 records that follow, uint32 older records overwritten, uint32 micros() at the dump
+//   then the records, oldest first
+#define FLIGHT_DUMP_VERSION 1
+
+struct FlightDumpHeader {
+  char magic[4];
+  uint8_t version;
+  uint8_t recordSize;
+  uint16_t capacity;
+  uint32_t records;
+  uint32_t overwritten;
+  uint32_t nowUs;
+};
+
+static bool dumpRunning = false;
+static bool dumpDebugMode = false;       // Debug output is held off so it can't land inside the binary data
+static uint32_t dumpNext = 0;            // Next record number (flightRecordCount based) to write
+static uint32_t dumpEnd = 0;
+
+void startFlightRecorderDump() {
+  if (dumpRunning) return;
+  
+  flightRecorderPaused = true;
+  dumpDebugMode = debugMode;
+  debugMode = false;
+  
+  uint32_t records = min(flightRecordCount, (uint32_t)FLIGHT_RECORDER_SIZE);
+  dumpEnd = flightRecordCount;
+  dumpNext = dumpEnd - records;
+  
+  Serial.printf("[RECORDER] Dump: %lu records\n", (unsigned long)records);
+  
+  FlightDumpHeader header = {{'E', 'V', 'F', 'R'}, FLIGHT_DUMP_VERSION, (uint8_t)sizeof(FlightRecord),
+                             (uint16_t)FLIGHT_RECORDER_SIZE, records, dumpNext, (uint32_t)micros()};
+  Serial.write((const uint8_t*)&header, sizeof(header));
+  dumpRunning = true;
+}
+
+bool serviceFlightRecorderDump() {
+  if (!dumpRunning) {
+    return false;
+  }
+  
+  // Whole records only, never more than the TX buffer takes without blocking
+  int space = Serial.availableForWrite();
+  while (dumpNext != dumpEnd && space >= (int)sizeof(FlightRecord)) {
+    uint32_t index = dumpNext & (FLIGHT_RECORDER_SIZE - 1);
+    uint32_t count = min(dumpEnd - dumpNext, (uint32_t)(FLIGHT_RECORDER_SIZE - index));
+    count = min(count, (uint32_t)(space / (int)sizeof(FlightRecord)));
+    
+    Serial.write((const uint8_t*)&flightRecords[index], count * sizeof(FlightRecord));
+    dumpNext += count;
+    space -= count * sizeof(FlightRecord);
+  }
+  
+  if (dumpNext == dumpEnd) {
+    Serial.println();
+    Serial.println("[RECORDER] Dump complete");
+    debugMode = dumpDebugMode;
+    flightRecorderPaused = false;
+    dumpRunning = false;
+  }
+  return true;
+}
+
+void clearFlightRecorder() {
+  flightRecordCount = 0;
+}
+
+void printFlightRecorderStats() {
+  uint32_t records = min(flightRecordCount, (uint32_t)FLIGHT_RECORDER_SIZE);
+  unsigned long spanMs = 0;
+  if (records > 0) {
+    const FlightRecord* oldest = &flightRecords[(flightRecordCount - records) & (FLIGHT_RECORDER_SIZE - 1)];
+    spanMs = (micros() - oldest->timeUs) / 1000;
+  }
+  Serial.printf("[RECORDER] Records: %lu/%d | Recorded since boot: %lu | Oldest: %lu ms ago\n",
+                (unsigned long)records, FLIGHT_RECORDER_SIZE, (unsigned long)flightRecordCount, spanMs);
+}
@@ -0,0 +1,7 @@
+#include "hardware.h"
+
+// ================================
+// HARDWARE LOOKUP TABLES
+// ================================
+// Evaluated by the compiler from the selected layout, nothing is computed at startup
+constexpr HardwareTables<Hardware> hw = buildHardwareTables<Hardware>();
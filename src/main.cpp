@@ -17,11 +17,17 @@
 #include "encoders.h"
 #include "midi.h"
 #include "utils.h"
+#include "watchdog.h"
+#include "flightRecorder.h"
+#include "power.h"
 
 void setup() {
   Serial.begin(115200);
   if (debugMode) delay(200);
 
+  initializeWatchdog();
+  recordFlightEvent(FLIGHT_BOOT, 0, 0, 0);
+
   debugPrint("EvoCmdWing setup");
 
   initializeEEPROM();
@@ -32,31 +38,47 @@ void setup() {
 
   setLogoPixels(127, 64, 0, config.logoBrightness); // orange
 
+  startWatchdog();
+  initializeIdle();
+
   debugPrint("Setup complete");
 }
 
 void loop() {
 
+  // Feed the hardware watchdog, each subsystem below is timed for stalls
+  serviceWatchdog();
+  beginLoopPass();
+
+  markSubsystem(SUBSYSTEM_MIDI_IN);
   handleIncomingMIDI();
+  markSubsystem(SUBSYSTEM_ENCODERS);
   handleEncoders();
+  markSubsystem(SUBSYSTEM_BUTTONS);
   handleButtons();
   
-  if (midiDataPending) {
-    usbMIDI.send_now();
-    midiDataPending = false;
-  }
+  // Send queued notes/CCs together so they share USB packets
+  markSubsystem(SUBSYSTEM_MIDI_OUT);
+  flushMidiOutput();
 
   // Handle midi often to keep teensy buffer from overflow
+  markSubsystem(SUBSYSTEM_MIDI_IN);
   handleIncomingMIDI();
   
-  // LED Update all colors at once 
-  if (hasPendingLEDUpdate && (millis() - lastMidiUpdateTime) >= MIDI_DEBOUNCE_MS) {
-    showStrip();
-    hasPendingLEDUpdate = false;
-  }
+  // Link replies queued by that pass (credits, digests, pongs) leave now, not behind the next pass
+  markSubsystem(SUBSYSTEM_MIDI_OUT);
+  flushMidiOutput();
   
-  updateXKeyLEDs();
+  // LED Update all colors at once, as soon as every changed XKey has its full status and RGB
+  // Blinking, pulsing, flashing and fading XKeys are redrawn first so they share the frame
+  markSubsystem(SUBSYSTEM_LED_FRAME);
+  serviceLEDEffects();
+  serviceLEDFrame();
   
+  markSubsystem(SUBSYSTEM_SERIAL);
   checkSerialForReboot();
 
+  // Sleep until the next interrupt unless work is already waiting
+  markSubsystem(SUBSYSTEM_IDLE);
+  idleUntilWork();
 }
\ No newline at end of file
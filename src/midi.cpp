@@ -1,6 +1,9 @@
 #include "midi.h"
 #include "neopixel.h"
+#include "encoders.h"
 #include "utils.h"
+#include "flightRecorder.h"
+#include "power.h"
 #include <MIDIUSB.h>
 
 // ================================
@@ -8,9 +11,9 @@
 // ================================
 
 
-// Page-based storage for up to 127 pages, 16 XKeys each
+// Page-based storage for up to 127 pages, NUM_XKEYS each
 // pageData[page][xkey] where page = 0-126 (for pages 1-127), xkey = 0-15 (for XKeys 1-16)
-ExecutorStatus pageData[127][16] = {0};
+ExecutorStatus pageData[127][NUM_XKEYS] = {0};
 
 // Current page tracking (1-127, but stored as 0-126 index)
 int currentPage = 0;  // Default to page 1 (index 0)
@@ -18,63 +21,515 @@ int currentPage = 0;  // Default to page 1 (index 0)
 // Current active status (points to current page data for convenience)
 ExecutorStatus* xkeyStatus = pageData[currentPage];
 
+// Page the plugin is writing channel 1/2 data for when it isn't the current one (prefetch), -1 = current page
+static int writePage = -1;
+
+// Phase (channel 3 CC 3) for the next LED effect command
+static byte nextEffectPhase = 0;
+
+// Receive rings, one per cable group, filled from usbMIDI only while they have space so nothing is ever dropped
+struct MidiMessage {
+  byte type;
+  byte channel;
+  byte data1;
+  byte data2;
+  byte cable;         // USB MIDI cable it arrived on, link replies go back on it
+};
+struct MidiRxRing {
+  MidiMessage slots[MIDI_RX_RING_SIZE];
+  int head;           // Next slot to write
+  int tail;           // Next slot to read
+  int count;
+};
+static MidiRxRing midiRx[MIDI_CABLES];
+
+// Read from usbMIDI while its ring was full, it goes in first on the next poll
+static MidiMessage heldMessage;
+static bool messageHeld = false;
+
+// Credit advertisement state
+static bool creditRequested = true;         // Advertise once at startup
+static byte creditCable = MIDI_CABLE_FEEDBACK;  // Cable of the last credit request, credits are for its ring
+static unsigned long lastCreditTime = 0;
+static byte creditRequestNumber = LINK_GRANT_UNREQUESTED;  // Echoed as the grant number
+
+struct MidiStats {
+  unsigned long received;       // Messages moved from usbMIDI into the ring
+  unsigned long processed;      // Messages handled
+  unsigned long ringFullPolls;  // Polls that left messages in the USB buffers because the ring was full
+  int ringHighWater;
+  unsigned long grants;         // Credit advertisements sent
+  unsigned long background;     // Channel 1/2 messages stored for a page that isn't shown (prefetch)
+  unsigned long digests;        // Page digest reports sent
+};
+static MidiStats midiStats = {0, 0, 0, 0, 0, 0, 0};
+
+// Per cable group throughput, rates over the last full MIDI_CABLE_RATE_WINDOW_MS window
+struct MidiCableStats {
+  unsigned long received;
+  unsigned long processed;
+  unsigned long sent;
+  int ringHighWater;
+  unsigned long windowReceived;   // Counts when the current window started
+  unsigned long windowSent;
+  unsigned long receivedPerSec;
+  unsigned long sentPerSec;
+  unsigned long peakReceivedPerSec;
+  unsigned long peakSentPerSec;
+};
+static MidiCableStats cableStats[MIDI_CABLES] = {};
+static unsigned long cableWindowStart = 0;
+static const char* const CABLE_NAMES[MIDI_CABLES] = {"Control", "Feedback"};
+
+// Plugin pings, answered from handleIncomingMIDI() with the ring depth behind them
+struct PingStats {
+  unsigned long pings;
+  int lastDepth;                // Messages still in the ring when the ping was handled
+  int maxDepth;
+  unsigned long lastWaitUs;     // Time the ping spent in the ring
+  unsigned long maxWaitUs;
+  unsigned long totalWaitUs;
+};
+static PingStats pingStats = {0, 0, 0, 0, 0, 0};
+static unsigned long pingArrivalUs[16] = {0};   // Per USB cable (4 bit number), micros() its last ping was moved into the ring
+
+// Outgoing queue, one list per priority
+enum MidiTxKind : byte {
+  MIDI_TX_NOTE,
+  MIDI_TX_CC,
+  MIDI_TX_CC_ABSOLUTE,
+  MIDI_TX_CC_RELATIVE
+};
+struct MidiTxEntry {
+  MidiTxKind kind;
+  byte channel;
+  byte data1;
+  int data2;          // Signed delta for relative CCs until sent
+  byte cable;
+};
+static MidiTxEntry midiTxQueue[2][MIDI_TX_QUEUE_SIZE];
+static int midiTxCount[2] = {0, 0};
+
+struct MidiTxStats {
+  unsigned long sent;           // Messages handed to usbMIDI
+  unsigned long coalesced;      // Messages merged into an entry already queued
+  unsigned long flushes;
+  unsigned long packets;        // USB packets used by the sent messages
+  unsigned long packetsSaved;   // Packets the coalesced messages would have added
+};
+static MidiTxStats midiTxStats = {0, 0, 0, 0, 0};
+static unsigned long coalescedSinceFlush = 0;
+
+// ================================
+// MIDI RECEIVE RINGS AND CREDITS
+// ================================
+// Cable 0 has the control ring, every other cable shares the feedback ring
+
+static inline MidiRxRing* rxRingFor(byte cable) {
+  return &midiRx[cable == MIDI_CABLE_CONTROL ? 0 : 1];
+}
+
+static inline MidiCableStats* cableStatsFor(byte cable) {
+  return &cableStats[cable == MIDI_CABLE_CONTROL ? 0 : 1];
+}
+
+// Queue a message in its cable's ring, false when that ring is full
+static bool pushMidiMessage(const MidiMessage* msg) {
+  MidiRxRing* ring = rxRingFor(msg->cable);
+  if (ring->count >= MIDI_RX_RING_SIZE) {
+    return false;
+  }
+  ring->slots[ring->head] = *msg;
+  ring->head = (ring->head + 1) % MIDI_RX_RING_SIZE;
+  ring->count++;
+  
+  MidiCableStats* stats = cableStatsFor(msg->cable);
+  stats->received++;
+  stats->ringHighWater = max(stats->ringHighWater, ring->count);
+  midiStats.ringHighWater = max(midiStats.ringHighWater, ring->count);
+  midiStats.received++;
+  return true;
+}
+
+// Move everything usbMIDI has into the rings. A message whose ring is full is held and reading
+// stops there, the rest stays in the USB buffers (all cables share one endpoint)
+static void pollMidiInput() {
+  if (messageHeld) {
+    if (!pushMidiMessage(&heldMessage)) {
+      midiStats.ringFullPolls++;
+      return;
+    }
+    messageHeld = false;
+  }
+  
+  while (usbMIDI.read()) {
+    noteInputHandled();
+    
+    MidiMessage msg;
+    msg.type = usbMIDI.getType();
+    msg.channel = usbMIDI.getChannel();
+    msg.data1 = usbMIDI.getData1();
+    msg.data2 = usbMIDI.getData2();
+    msg.cable = usbMIDI.getCable();
+    recordFlightEvent(FLIGHT_MIDI_IN, msg.type | ((msg.channel - 1) & 0x0F), msg.data1, msg.data2);
+    if (msg.type == usbMIDI.ControlChange && msg.channel == wingToMidiChannel(LINK_MIDI_CHANNEL) &&
+        msg.data1 == LINK_CC_PING) {
+      pingArrivalUs[msg.cable & 0x0F] = micros();
+    }
+    
+    if (!pushMidiMessage(&msg)) {
+      heldMessage = msg;
+      messageHeld = true;
+      midiStats.ringFullPolls++;
+      return;
+    }
+  }
+}
+
+// Free slots in the feedback ring, where the plugin's bulk traffic waits
+int midiRxFree() {
+  return MIDI_RX_RING_SIZE - rxRingFor(MIDI_CABLE_FEEDBACK)->count;
+}
+
+static int midiRxPending() {
+  int pending = 0;
+  for (int i = 0; i < MIDI_CABLES; i++) {
+    pending += midiRx[i].count;
+  }
+  return pending;
+}
+
+bool midiWorkPending() {
+  return midiRxPending() > 0 || messageHeld || midiTxCount[MIDI_TX_HIGH] > 0 || midiTxCount[MIDI_TX_LOW] > 0 || creditRequested;
+}
+
+// Advertise free ring slots to the plugin, the grant number is the request number it answers
+// Credits are for the ring of the cable the last request came in on, and go back on that cable
+// A keepalive answers no request (LINK_GRANT_UNREQUESTED), the plugin never spends its credits
+void sendMidiCredits() {
+  int free = MIDI_RX_RING_SIZE - rxRingFor(creditCable)->count;
+  int credits = constrain(free - MIDI_CREDIT_RESERVE, 0, 127);
+  byte grant = creditRequested ? creditRequestNumber : LINK_GRANT_UNREQUESTED;
+  
+  // Credits first, the plugin only reads them once it sees the grant for its request
+  queueControlChange(LINK_CC_CREDITS, credits, wingToMidiChannel(LINK_MIDI_CHANNEL), MIDI_TX_LOW, creditCable);
+  queueControlChange(LINK_CC_GRANT, grant, wingToMidiChannel(LINK_MIDI_CHANNEL), MIDI_TX_LOW, creditCable);
+  
+  creditRequested = false;
+  creditRequestNumber = LINK_GRANT_UNREQUESTED;
+  lastCreditTime = millis();
+  midiStats.grants++;
+}
+
+// Close the throughput window once it is MIDI_CABLE_RATE_WINDOW_MS old
+static void updateCableRates() {
+  unsigned long now = millis();
+  unsigned long elapsed = now - cableWindowStart;
+  if (elapsed < MIDI_CABLE_RATE_WINDOW_MS) {
+    return;
+  }
+  for (int i = 0; i < MIDI_CABLES; i++) {
+    MidiCableStats* stats = &cableStats[i];
+    stats->receivedPerSec = (stats->received - stats->windowReceived) * 1000 / elapsed;
+    stats->sentPerSec = (stats->sent - stats->windowSent) * 1000 / elapsed;
+    stats->peakReceivedPerSec = max(stats->peakReceivedPerSec, stats->receivedPerSec);
+    stats->peakSentPerSec = max(stats->peakSentPerSec, stats->sentPerSec);
+    stats->windowReceived = stats->received;
+    stats->windowSent = stats->sent;
+  }
+  cableWindowStart = now;
+}
+
+void printMidiStats() {
+  Serial.printf("[MIDI STATS] Received: %lu | Processed: %lu | Ring: %d/%d (high water %d) | Ring full polls: %lu | Grants: %lu | Prefetched: %lu | Digests: %lu\n",
+                midiStats.received, midiStats.processed, midiRxPending(), MIDI_RX_RING_SIZE * MIDI_CABLES,
+                midiStats.ringHighWater, midiStats.ringFullPolls, midiStats.grants, midiStats.background, midiStats.digests);
+  for (int i = 0; i < MIDI_CABLES; i++) {
+    const MidiCableStats* stats = &cableStats[i];
+    Serial.printf("[MIDI CABLE] %s: In: %lu (%lu/s, peak %lu/s) | Handled: %lu | Out: %lu (%lu/s, peak %lu/s) | Ring: %d/%d (high water %d)\n",
+                  CABLE_NAMES[i], stats->received, stats->receivedPerSec, stats->peakReceivedPerSec, stats->processed,
+                  stats->sent, stats->sentPerSec, stats->peakSentPerSec,
+                  midiRx[i].count, MIDI_RX_RING_SIZE, stats->ringHighWater);
+  }
+  Serial.printf("[MIDI STATS] Sent: %lu | Coalesced: %lu | Flushes: %lu | Packets: %lu | Packets saved: %lu\n",
+                midiTxStats.sent, midiTxStats.coalesced, midiTxStats.flushes,
+                midiTxStats.packets, midiTxStats.packetsSaved);
+  unsigned long avgWaitUs = pingStats.pings ? pingStats.totalWaitUs / pingStats.pings : 0;
+  Serial.printf("[MIDI STATS] Pings: %lu | Ring wait us last: %lu avg: %lu max: %lu | Depth last: %d max: %d\n",
+                pingStats.pings, pingStats.lastWaitUs, avgWaitUs, pingStats.maxWaitUs,
+                pingStats.lastDepth, pingStats.maxDepth);
+}
+
+// Answer a plugin ping on its cable: depth of that cable's ring first, the plugin reads it once the ID CC shows its ping
+static void sendPong(byte id, byte cable) {
+  unsigned long waitUs = micros() - pingArrivalUs[cable & 0x0F];
+  int depth = rxRingFor(cable)->count;
+  queueControlChange(LINK_CC_PONG_DEPTH, min(depth, 127), wingToMidiChannel(LINK_MIDI_CHANNEL), MIDI_TX_LOW, cable);
+  queueControlChange(LINK_CC_PONG, id, wingToMidiChannel(LINK_MIDI_CHANNEL), MIDI_TX_LOW, cable);
+  
+  pingStats.pings++;
+  pingStats.lastDepth = depth;
+  pingStats.maxDepth = max(pingStats.maxDepth, depth);
+  pingStats.lastWaitUs = waitUs;
+  pingStats.maxWaitUs = max(pingStats.maxWaitUs, waitUs);
+  pingStats.totalWaitUs += waitUs;
+  tracePrintf(TRACE_MIDI_IN, "[MIDI CH4] Ping %d | Ring wait %lu us | Depth %d | Cable %d", id, waitUs, depth, cable);
+}
+
+// ================================
+// PAGE DIGESTS
+// ================================
+// Per XKey: status value (0/65/127), RGB when populated, and for keys with an absolute encoder the fader
+// value (128 until one was received or turned). The plugin hashes the same bytes the same way.
+static inline uint32_t digestValue(uint32_t hash, int value) {
+  return (hash * 31 + value) % 16381;   // Largest prime below 2^14
+}
+
+uint16_t pageGroupDigest(int page, int group) {
+  uint32_t hash = 1;
+  int first = group * PAGE_DIGEST_KEYS;
+  for (int i = first; i < first + PAGE_DIGEST_KEYS && i < NUM_XKEYS; i++) {
+    const ExecutorStatus* status = &pageData[page][i];
+    hash = digestValue(hash, status->isPopulated ? (status->isOn ? 127 : 65) : 0);
+    if (status->isPopulated) {
+      hash = digestValue(hash, status->red);
+      hash = digestValue(hash, status->green);
+      hash = digestValue(hash, status->blue);
+    }
+    if (hw.xkeyEncoder[i] >= 0) {
+      hash = digestValue(hash, status->hasFaderValue ? status->faderValue : 128);
+    }
+  }
+  return (uint16_t)hash;
+}
+
+// Digests first, the plugin reads them once the number CC shows its request number
+void sendPageDigests(int page, byte requestNumber, byte cable) {
+  for (int group = 0; group < PAGE_DIGEST_GROUPS; group++) {
+    uint16_t digest = pageGroupDigest(page, group);
+    queueControlChange(LINK_CC_DIGEST + group, digest & 0x7F, wingToMidiChannel(LINK_MIDI_CHANNEL), MIDI_TX_LOW, cable);
+    queueControlChange(LINK_CC_DIGEST_HIGH + group, digest >> 7, wingToMidiChannel(LINK_MIDI_CHANNEL), MIDI_TX_LOW, cable);
+  }
+  queueControlChange(LINK_CC_DIGEST_NUMBER, requestNumber, wingToMidiChannel(LINK_MIDI_CHANNEL), MIDI_TX_LOW, cable);
+  midiStats.digests++;
+}
+
+// ================================
+// MIDI OUTGOING QUEUE
+// ================================
+
+static inline int relativeToDelta(int value) {
+  return (value < 64) ? value : -(value - 64);
+}
+
+static inline byte deltaToRelative(int delta) {
+  return (byte)((delta >= 0) ? delta : 64 - delta);
+}
+
+// Encoder and button output (high priority) is control cable traffic, only link replies pick a cable
+// Newest entry first: once a relative entry is full the next one takes the following steps
+static MidiTxEntry* findQueuedCC(int priority, MidiTxKind kind, byte channel, byte cc) {
+  for (int i = midiTxCount[priority] - 1; i >= 0; i--) {
+    MidiTxEntry* entry = &midiTxQueue[priority][i];
+    if (entry->kind == kind && entry->channel == channel && entry->data1 == cc) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+static void appendMidiTx(int priority, MidiTxKind kind, byte channel, byte data1, int data2, byte cable = MIDI_CABLE_CONTROL) {
+  if (midiTxCount[priority] >= MIDI_TX_QUEUE_SIZE) {
+    // Full, send what we have now rather than drop anything
+    flushMidiOutput();
+  }
+  MidiTxEntry* entry = &midiTxQueue[priority][midiTxCount[priority]++];
+  entry->kind = kind;
+  entry->channel = channel;
+  entry->data1 = data1;
+  entry->data2 = data2;
+  entry->cable = cable;
+}
+
+void queueNoteOn(byte note, byte velocity, byte channel) {
+  appendMidiTx(MIDI_TX_HIGH, MIDI_TX_NOTE, channel, note, velocity);
+}
+
+// Only the newest absolute value for an XKey encoder matters
+void queueAbsoluteCC(byte cc, byte value, byte channel) {
+  MidiTxEntry* entry = findQueuedCC(MIDI_TX_HIGH, MIDI_TX_CC_ABSOLUTE, channel, cc);
+  if (entry) {
+    entry->data2 = value;
+    midiTxStats.coalesced++;
+    coalescedSinceFlush++;
+    return;
+  }
+  appendMidiTx(MIDI_TX_HIGH, MIDI_TX_CC_ABSOLUTE, channel, cc, value);
+}
+
+// Relative steps are summed into the newest entry while its total stays within what the plugin accepts
+void queueRelativeCC(byte cc, byte value, byte channel) {
+  int delta = relativeToDelta(value);
+  MidiTxEntry* entry = findQueuedCC(MIDI_TX_HIGH, MIDI_TX_CC_RELATIVE, channel, cc);
+  if (entry && abs(entry->data2 + delta) <= RELATIVE_CC_MAX_STEP) {
+    entry->data2 += delta;
+    midiTxStats.coalesced++;
+    coalescedSinceFlush++;
+    return;
+  }
+  appendMidiTx(MIDI_TX_HIGH, MIDI_TX_CC_RELATIVE, channel, cc, delta);
+}
+
+void queueControlChange(byte cc, byte value, byte channel, MidiTxPriority priority, byte cable) {
+  appendMidiTx(priority, MIDI_TX_CC, channel, cc, value, cable);
+}
+
+// Send everything queued, high priority first, then one send_now() so the messages fill packets
+void flushMidiOutput() {
+  int sent = 0;
+  
+  for (int priority = MIDI_TX_HIGH; priority <= MIDI_TX_LOW; priority++) {
+    for (int i = 0; i < midiTxCount[priority]; i++) {
+      MidiTxEntry* entry = &midiTxQueue[priority][i];
+      
+      if (entry->kind == MIDI_TX_NOTE) {
+        usbMIDI.sendNoteOn(entry->data1, entry->data2, entry->channel, entry->cable);
+        recordFlightEvent(FLIGHT_MIDI_OUT, 0x90 | ((entry->channel - 1) & 0x0F), entry->data1, entry->data2);
+      } else {
+        byte value;
+        if (entry->kind == MIDI_TX_CC_RELATIVE) {
+          if (entry->data2 == 0) continue;  // Steps cancelled out
+          value = deltaToRelative(entry->data2);
+        } else {
+          value = entry->data2;
+        }
+        usbMIDI.sendControlChange(entry->data1, value, entry->channel, entry->cable);
+        recordFlightEvent(FLIGHT_MIDI_OUT, 0xB0 | ((entry->channel - 1) & 0x0F), entry->data1, value);
+      }
+      cableStatsFor(entry->cable)->sent++;
+      sent++;
+    }
+    midiTxCount[priority] = 0;
+  }
+  
+  if (sent == 0) {
+    coalescedSinceFlush = 0;
+    return;
+  }
+  
+  usbMIDI.send_now();
+  
+  unsigned long packets = (sent + MIDI_MESSAGES_PER_PACKET - 1) / MIDI_MESSAGES_PER_PACKET;
+  unsigned long uncoalescedPackets = (sent + coalescedSinceFlush + MIDI_MESSAGES_PER_PACKET - 1) / MIDI_MESSAGES_PER_PACKET;
+  midiTxStats.sent += sent;
+  midiTxStats.flushes++;
+  midiTxStats.packets += packets;
+  midiTxStats.packetsSaved += uncoalescedPackets - packets;
+  coalescedSinceFlush = 0;
+}
+
 // ================================
 // MIDI COMMUNICATION FUNCTIONS
 // ================================
 
 void handleIncomingMIDI() {
+  pollMidiInput();
+  updateCableRates();
+  
   // Limit messages processed per loop
-  // This prevents buffer overflow from locking up the system while still processing rapidly, probably overkill
+  // This keeps a burst from locking up encoder scanning, the rest waits in the ring
+  // The control ring is emptied first, a feedback burst only gets what is left of the budget
   int messageCount = 0;
   
-  while (usbMIDI.read() && messageCount < MAX_MESSAGES_PER_LOOP) {
-    messageCount++;
-    
-    byte type = usbMIDI.getType();
-    byte ch = usbMIDI.getChannel();
-    byte d1 = usbMIDI.getData1();
-    byte d2 = usbMIDI.getData2();
-
-    if (type == usbMIDI.ControlChange) {
-      if (ch == midiCh) {
-        // Channel 1: Encoder feedback
-        for (int i = 5; i < N_ENCODERS; i++) {
-          if (d1 == ENCODER_NOTES[i]) {
-            encoderValues[i] = constrain(d2, 0, 127);
-            debugPrintf("[MIDI IN CH1] CC Update - Encoder %d | CC: %d | Value: %d", (i + 1), d1, encoderValues[i]);
-            break;
+  for (int r = 0; r < MIDI_CABLES; r++) {
+    MidiRxRing* ring = &midiRx[r];
+    while (ring->count > 0 && messageCount < MAX_MESSAGES_PER_LOOP) {
+      messageCount++;
+      
+      MidiMessage* msg = &ring->slots[ring->tail];
+      ring->tail = (ring->tail + 1) % MIDI_RX_RING_SIZE;
+      ring->count--;
+      midiStats.processed++;
+      cableStats[r].processed++;
+      
+      byte type = msg->type;
+      int ch = midiToWingChannel(msg->channel);  // 1-4 on this wing's channel block
+      byte d1 = msg->data1;
+      byte d2 = msg->data2;
+
+      if (type == usbMIDI.ControlChange) {
+        if (ch == midiCh) {
+          // Channel 1: Encoder feedback (held while the encoder is being turned)
+          int encoderIndex = hw.feedbackEncoder[d1 & 0x7F];
+          if (encoderIndex >= 0 && writePage >= 0) {
+            // Prefetched fader value for another page, kept for its next page load
+            storeBackgroundEncoderValue(writePage, encoderIndex, d2);
+            midiStats.background++;
+            tracePrintf(TRACE_MIDI_IN, "[MIDI IN CH1] Page %d Encoder %d | CC: %d | Value: %d (prefetch)", writePage + 1, (encoderIndex + 1), d1, d2);
+          } else if (encoderIndex >= 0) {
+            setEncoderFeedback(encoderIndex, d2);
+            tracePrintf(TRACE_MIDI_IN, "[MIDI IN CH1] CC Update - Encoder %d | CC: %d | Value: %d", (encoderIndex + 1), d1, d2);
           }
+        } else if (ch == 2) {
+          // Channel 2: XKey status data
+          handleStatusMIDI(ch, d1, d2);
+        } else if (ch == 3) {
+          // Channel 3: Page changes
+          handlePageMIDI(ch, d1, d2);
+        } else if (ch == LINK_MIDI_CHANNEL) {
+          // Channel 4: Plugin link requests
+          handleLinkMIDI(ch, d1, d2, msg->cable);
         }
-      } else if (ch == 2) {
-        // Channel 2: XKey status data
-        handleStatusMIDI(ch, d1, d2);
-      } else if (ch == 3) {
-        // Channel 3: Page changes
-        handlePageMIDI(ch, d1, d2);
       }
-    }
 
-// =====================================
-// EXTRA DEBUG NO LONGER NEEDED
-// =====================================
-  //   const char* typeStr;
-  // switch (type) {
-  //   case usbMIDI.NoteOff: typeStr = "Note Off   "; break;
-  //   case usbMIDI.NoteOn: typeStr = "Note On    "; break;
-  //   case usbMIDI.AfterTouchPoly: typeStr = "Aftertouch "; break;
-  //   case usbMIDI.ControlChange: typeStr = "CC         "; break;
-  //   case usbMIDI.ProgramChange: typeStr = "Program    "; break;
-  //   case usbMIDI.AfterTouchChannel: typeStr = "Channel Pressure"; break;
-  //   case usbMIDI.PitchBend: typeStr = "Pitch Bend "; break;
-  //   default: typeStr = "Other      "; break;
-  // }
-  //   debugPrintf("[MIDI IN] Type: %s Ch: %d D1: %d D2: %d", typeStr, ch, d1, d2);
-  
+  // =====================================
+  // EXTRA DEBUG NO LONGER NEEDED
+  // =====================================
+    //   const char* typeStr;
+    // switch (type) {
+    //   case usbMIDI.NoteOff: typeStr = "Note Off   "; break;
+    //   case usbMIDI.NoteOn: typeStr = "Note On    "; break;
+    //   case usbMIDI.AfterTouchPoly: typeStr = "Aftertouch "; break;
+    //   case usbMIDI.ControlChange: typeStr = "CC         "; break;
+    //   case usbMIDI.ProgramChange: typeStr = "Program    "; break;
+    //   case usbMIDI.AfterTouchChannel: typeStr = "Channel Pressure"; break;
+    //   case usbMIDI.PitchBend: typeStr = "Pitch Bend "; break;
+    //   default: typeStr = "Other      "; break;
+    // }
+    //   debugPrintf("[MIDI IN] Type: %s Ch: %d D1: %d D2: %d", typeStr, ch, d1, d2);
+    }
   }
   
   // Alert if we hit the message limit (indicates potential MIDI flooding)
   if (messageCount >= MAX_MESSAGES_PER_LOOP) {
-    debugPrintf("[MIDI FLOOD] Processed %d messages (limit reached) - more pending", messageCount);
+    debugPrintf("[MIDI FLOOD] Processed %d messages (limit reached) - %d pending", messageCount, midiRxPending());
+  }
+  
+  // Answer credit requests once the burst ahead of them has been handled, plus a slow keepalive
+  if (creditRequested || (millis() - lastCreditTime) >= MIDI_CREDIT_KEEPALIVE_MS) {
+    sendMidiCredits();
+  }
+}
+
+// ================================
+// WING LINK MIDI HANDLER
+// ================================
+// Handles MIDI Channel 4 requests from the plugin, answers go back on the cable the request came in on
+// CC 1 = credit request, answered after the current batch is processed
+// CC 2 = page digest request, answered with the current page's digests (the page change comes first)
+// CC 3 = ping, answered right away with the ring depth (flushed as soon as this input pass is done)
+void handleLinkMIDI(byte ch, byte cc, byte value, byte cable) {
+  if (cc == LINK_CC_CREDITS) {
+    creditRequested = true;
+    creditRequestNumber = value & 0x7F;
+    creditCable = cable;
+  } else if (cc == LINK_CC_PING) {
+    sendPong(value, cable);
+  } else if (cc == LINK_CC_DIGEST_REQUEST) {
+    sendPageDigests(currentPage, value, cable);
+    tracePrintf(TRACE_PAGE, "[PAGE] Digest request %d for page %d", value, currentPage + 1);
+  } else {
+    tracePrintf(TRACE_MIDI_IN, "[MIDI CH4] Unknown CC: %d Value: %d", cc, value);
   }
 }
 
@@ -83,54 +538,73 @@ void handleIncomingMIDI() {
 // ================================
 // Handles MIDI Channel 3 data for page changes
 // CC 1 = Current page number (1-127)
+// CC 2 = Write page (1-127), channel 1/2 data that follows is stored for that page without touching
+//        the LEDs or encoders, 0 or a page change goes back to the current page
 // When page changes, updates current page pointer and refreshes all LEDs
 void handlePageMIDI(byte ch, byte cc, byte value) {
-  if (ch == 3 && cc == 1) {
+  if (ch == 3 && cc == PAGE_CC_WRITE) {
+    int pageIndex = constrain(value, 0, 127) - 1;
+    writePage = (pageIndex == currentPage) ? -1 : pageIndex;
+    if (writePage >= 0) {
+      tracePrintf(TRACE_PAGE, "[PAGE] Writing page %d (prefetch)", writePage + 1);
+    } else {
+      tracePrintf(TRACE_PAGE, "[PAGE] Writing current page");
+    }
+  } else if (ch == 3 && cc == PAGE_CC_CURRENT) {
     // Page change on Channel 3, CC 1
     int newPage = constrain(value, 1, 127);  // Ensure valid page range
     int newPageIndex = newPage - 1;  // Convert to 0-126 index
+    writePage = -1;
     
     if (newPageIndex != currentPage) {
       int oldPage = currentPage + 1;  // Convert back to 1-127 for display
       currentPage = newPageIndex;
+      recordFlightEvent(FLIGHT_PAGE, newPage, oldPage, 0);
       
       // Update pointer to current page data
       xkeyStatus = pageData[currentPage];
       
-      debugPrintf("[PAGE CHANGE] %d → %d (loading cached data)", oldPage, newPage);
+      // Absolute encoders continue from the new page's cached fader values, the plugin's sync confirms them
+      loadPageEncoderValues();
       
-      // Update all LEDs with new page data
-      bool anyLEDChanged = false;
-      for (int i = 0; i < NUM_XKEYS; i++) {
-        ExecutorStatus* status = &xkeyStatus[i];
-        
-        if (!status->isPopulated) {
-          // Key not populated - turn LEDs off
-          setXKeyLED(i, 0, 0, 0, 0.0);
-          anyLEDChanged = true;
-        } else if (status->isPopulated && !status->isOn) {
-          // Key populated but not on
-          setXKeyLED(i, status->red, status->green, status->blue, config.offBrightness);
-          anyLEDChanged = true;
-        } else if (status->isPopulated && status->isOn) {
-          // Key populated and on
-          setXKeyLED(i, status->red, status->green, status->blue, config.onBrightness);
-          anyLEDChanged = true;
-        }
-      }
+      tracePrintf(TRACE_PAGE, "[PAGE CHANGE] %d → %d (loading cached data)", oldPage, newPage);
       
-      // Single LED update for entire page
-      if (anyLEDChanged) {
-        showStrip();
-        debugPrintf("[LED] Page %d loaded - all LEDs updated", newPage);
-      }
+      // Update all LEDs with new page data, a copy when the page was shown before, effects on top
+      loadPageEffects(currentPage);
+      loadPageLEDs(currentPage);
+      
+      // Partial RGB triplets belonged to the old page, show the new page on the next frame
+      resetLEDFrameTracking();
+      requestLEDFrame();
+      tracePrintf(TRACE_PAGE, "[LED] Page %d loaded - all LEDs updated", newPage);
       
-      debugPrintf("[PAGE] Now on page %d", newPage);
+      tracePrintf(TRACE_PAGE, "[PAGE] Now on page %d", newPage);
     } else {
-      debugPrintf("[PAGE] Already on page %d", newPage);
+      tracePrintf(TRACE_PAGE, "[PAGE] Already on page %d", newPage);
     }
+  } else if (ch == 3 && cc == EFFECT_CC_PHASE) {
+    nextEffectPhase = value & 0x7F;
+  } else if (ch == 3 && cc >= EFFECT_CC_FIRST && cc < EFFECT_CC_FIRST + NUM_XKEYS) {
+    // LED effect for the current or write page, the phase only applies to this command
+    int page = (writePage >= 0) ? writePage : currentPage;
+    setExecutorEffect(page, cc - EFFECT_CC_FIRST, value, nextEffectPhase);
+    nextEffectPhase = 0;
   } else {
-    debugPrintf("[MIDI CH3] Unknown CC: %d Value: %d (Expected: CC 1 for page changes)", cc, value);
+    tracePrintf(TRACE_PAGE, "[MIDI CH3] Unknown CC: %d Value: %d (Expected: CC 1 page change, CC 2 write page, CC %d effect phase, CC %d-%d effects)",
+                cc, value, EFFECT_CC_PHASE, EFFECT_CC_FIRST, EFFECT_CC_FIRST + NUM_XKEYS - 1);
+  }
+}
+
+// Stores an XKey's LED effect (effect * 16 + rate) for a page, unknown effects clear it
+void setExecutorEffect(int page, int xkeyIndex, byte value, byte phase) {
+  ExecutorStatus* status = &pageData[page][xkeyIndex];
+  status->effect = ((value >> 4) < LED_EFFECT_COUNT) ? (value & 0x7F) : 0;
+  status->effectPhase = phase & 0x7F;
+  
+  tracePrintf(TRACE_PAGE, "[EFFECT] Page %d XKey %d: %s rate %d phase %d", page + 1, xkeyIndex + 1,
+              ledEffectName(status->effect >> 4), status->effect & 0x0F, status->effectPhase);
+  if (page == currentPage) {
+    setXKeyEffect(xkeyIndex, status);
   }
 }
 
@@ -154,28 +628,26 @@ void handlePageMIDI(byte ch, byte cc, byte value) {
 //     ...
 //     XKey 16: Red=CC62, Green=CC63, Blue=CC64
 //   Pattern: XKey N uses CC (16 + (N-1)*3 + 1) through CC (16 + N*3)
+//
+// Both ranges follow the layout's XKey count (status CC 1-N, RGB CC N+1 to 4N), decoded with the hw lookup tables
+// Data for a write page (channel 3 CC 2) only updates that page's data and color cache
 void handleStatusMIDI(byte ch, byte cc, byte value) {
   int xkeyIndex = -1;
   const char* dataType = "Unknown";
-  int executorNumber = -1;
+  int page = (writePage >= 0) ? writePage : currentPage;
+  bool background = (page != currentPage);
+  cc &= 0x7F;
   
-  if (cc >= 1 && cc <= 16) {
+  if (hw.statusXKey[cc] >= 0) {
     // Status data: CC 1-16 for XKeys 1-16
-    xkeyIndex = cc - 1;
-    int xkeyNumber = cc;
+    xkeyIndex = hw.statusXKey[cc];
+    int xkeyNumber = xkeyIndex + 1;
+    int executorNumber = hw.xkeys[xkeyIndex].executor;
     dataType = "Status";
     
-    // Determine executor number based on XKey number
-    if (xkeyNumber >= 1 && xkeyNumber <= 8) {
-      // XKeys 1-8 = Executors 291-298
-      executorNumber = 290 + xkeyNumber;
-    } else if (xkeyNumber >= 9 && xkeyNumber <= 16) {
-      // XKeys 9-16 = Executors 191-198  
-      executorNumber = 182 + xkeyNumber;  // 191 = 182 + 9
-    }
-    
-    // Store in current page data
-    ExecutorStatus* status = &pageData[currentPage][xkeyIndex];
+    // Store in the page's data
+    ExecutorStatus* status = &pageData[page][xkeyIndex];
+    bool wasPopulated = status->isPopulated;
     
     // Decode combined status value
     if (value == 0) {
@@ -196,76 +668,64 @@ void handleStatusMIDI(byte ch, byte cc, byte value) {
       status->isOn = false;
     }
     
-    debugPrintf("[MIDI CH2] Page %d XKey %d (Exec %d) %s: %d (Pop=%s On=%s)", 
-                currentPage + 1, xkeyNumber, executorNumber, dataType, value,
+    // Newly populated keys are always followed by their RGB triplet, hold the frame for it
+    if (!background) {
+      markXKeyStatusPending(xkeyIndex, !wasPopulated && status->isPopulated);
+    }
+    
+    tracePrintf(TRACE_STATUS, "[MIDI CH2] Page %d XKey %d (Exec %d) %s: %d (Pop=%s On=%s)", 
+                page + 1, xkeyNumber, executorNumber, dataType, value,
                 status->isPopulated ? "YES" : "NO",
                 status->isOn ? "ON" : "OFF");
                 
-  } else if (cc >= 17 && cc <= 64) {
+  } else if (hw.colorXKey[cc] >= 0) {
     // RGB color data: CC 17-64 for XKeys 1-16 (3 CCs each)
-    // Pattern: XKey N uses CC (16 + (N-1)*3 + 1) through CC (16 + N*3)
-    int colorCC = cc - 17;  // 0-47 (48 total CCs for 16 XKeys * 3 colors)
-    xkeyIndex = colorCC / 3;  // XKey index 0-15
-    int colorComponent = colorCC % 3;  // 0=Red, 1=Green, 2=Blue
+    xkeyIndex = hw.colorXKey[cc];
+    int colorComponent = hw.colorComponent[cc];  // 0=Red, 1=Green, 2=Blue
     
-    if (xkeyIndex >= 0 && xkeyIndex < 16) {
-      int xkeyNumber = xkeyIndex + 1;  // XKey 1-16
-      
-      // Determine executor number
-      if (xkeyNumber >= 1 && xkeyNumber <= 8) {
-        executorNumber = 290 + xkeyNumber;
-      } else if (xkeyNumber >= 9 && xkeyNumber <= 16) {
-        executorNumber = 182 + xkeyNumber;
-      }
-      
-      // Store in current page data
-      ExecutorStatus* status = &pageData[currentPage][xkeyIndex];
-      
-      // Set color component
-      switch (colorComponent) {
-        case 0:  // Red
-          dataType = "Red";
-          status->red = value;
-          break;
-        case 1:  // Green
-          dataType = "Green";
-          status->green = value;
-          break;
-        case 2:  // Blue
-          dataType = "Blue";
-          status->blue = value;
-          break;
-      }
-      
-      debugPrintf("[MIDI CH2] Page %d XKey %d (Exec %d) %s: %d (CC:%d)", 
-                  currentPage + 1, xkeyNumber, executorNumber, dataType, value, cc);
+    int xkeyNumber = xkeyIndex + 1;  // XKey 1-16
+    int executorNumber = hw.xkeys[xkeyIndex].executor;
+    
+    // Store in the page's data
+    ExecutorStatus* status = &pageData[page][xkeyIndex];
+    
+    // Set color component
+    switch (colorComponent) {
+      case 0:  // Red
+        dataType = "Red";
+        status->red = value;
+        break;
+      case 1:  // Green
+        dataType = "Green";
+        status->green = value;
+        break;
+      case 2:  // Blue
+        dataType = "Blue";
+        status->blue = value;
+        break;
     }
+    if (!background) {
+      markXKeyColorPending(xkeyIndex, colorComponent);
+    }
+    
+    tracePrintf(TRACE_STATUS, "[MIDI CH2] Page %d XKey %d (Exec %d) %s: %d (CC:%d)", 
+                page + 1, xkeyNumber, executorNumber, dataType, value, cc);
   } else {
-    debugPrintf("[MIDI CH2] Unknown CC: %d Value: %d (Valid range: CC 1-64)", cc, value);
+    tracePrintf(TRACE_STATUS, "[MIDI CH2] Unknown CC: %d Value: %d (Valid range: CC 1-%d)", cc, value, NUM_XKEYS * 4);
   }
 
   // Update LED for changed XKey and display complete status
-  if (xkeyIndex >= 0 && xkeyIndex < 16) {
+  if (xkeyIndex >= 0 && background) {
+    // Prefetched page, ready in the color cache for the page change
+    cachePageXKeyStatus(page, xkeyIndex, &pageData[page][xkeyIndex]);
+    midiStats.background++;
+  } else if (xkeyIndex >= 0) {
     ExecutorStatus* status = &pageData[currentPage][xkeyIndex];
     //int xkeyNumber = xkeyIndex + 1;
     
-    // Update LED immediately for this XKey
-    if (!status->isPopulated) {
-      // Key not populated - turn LEDs off
-      setXKeyLED(xkeyIndex, 0, 0, 0, 0.0);
-    } else if (status->isPopulated && !status->isOn) {
-      // Key populated but not on - 5% brightness
-      setXKeyLED(xkeyIndex, status->red, status->green, status->blue, config.offBrightness);
-    } else if (status->isPopulated && status->isOn) {
-      // Key populated and on - full brightness
-      setXKeyLED(xkeyIndex, status->red, status->green, status->blue, config.onBrightness);
-    }
-    
-    // Mark that we have pending LED updates
-    // Instead of calling showStrip() immediately, wait for a brief pause
-    // Update on interval for cleaner led updates
-    hasPendingLEDUpdate = true;
-    lastMidiUpdateTime = millis();
+    // Update LED buffer immediately for this XKey
+    // The frame scheduler shows it once the key's RGB triplet is complete
+    renderXKeyStatus(xkeyIndex, status);
     
     // ===================================
     // Redundant debug output for testing
@@ -1,41 +1,88 @@
 #include "neopixel.h"
 #include "utils.h"
+#include "flightRecorder.h"
 #include <algorithm>
 #include <cmath>
+#include <type_traits>
 
 // ================================
 // NEOPIXEL GLOBAL VARIABLES
 // ================================
 
-// Default LED mapping - can be manually adjusted if physical layout differs
-// Starting after logo pixels (6) (pixels 0-5), then skip 1, then 2 LEDs per key with 1 skip between
-XKeyLEDMapping xkeyLEDMap[NUM_XKEYS] = {
-  {7, 8},     // XKey 1
-  {10, 11},   // XKey 2
-  {13, 14},   // XKey 3
-  {16, 17},   // XKey 4
-  
-  {20, 21},   // XKey 5
-  {23, 24},   // XKey 6
-  {26, 27},   // XKey 7
-  {29, 30},   // XKey 8
-
-  {32, 33},   // XKey 9
-  {35, 36},   // XKey 10
-  {38, 39},   // XKey 11
-  {41, 42},   // XKey 12
-
-  {45, 46},   // XKey 13
-  {48, 49},   // XKey 14
-  {51, 52},   // XKey 15
-  {54, 55}    // XKey 16
-};
+// XKey pixel pairs come from the hardware layout (hw.xkeys), edit the layout in hardware.h if the physical strip differs
 
 // Note: Brightness controls moved to config struct in eeprom.h
 
-// LED Update Debounce System
-unsigned long lastMidiUpdateTime = 0;
-bool hasPendingLEDUpdate = false;
+// LED Frame Scheduler
+// Bit per XKey, wide enough for the layout's key count
+typedef std::conditional<(NUM_XKEYS > 16), uint32_t, uint16_t>::type XKeyMask;
+static XKeyMask ledDirtyKeys = 0;                 // Bit per XKey with changes not yet shown
+static XKeyMask ledIncompleteKeys = 0;            // Bit per XKey still waiting on part of an RGB triplet
+static uint8_t xkeyColorParts[NUM_XKEYS] = {0};   // Bit per RGB component received for the current triplet
+static bool ledFullFramePending = false;          // Whole strip changed (page change, brightness)
+static unsigned long ledFrameFirstChangeUs = 0;   // micros() of the oldest change not yet shown
+static unsigned long lastLEDFrameMs = 0;          // millis() of the last frame shown
+
+// Latency from first change to strip.show(), reported by printLEDFrameStats()
+struct LEDFrameStats {
+  unsigned long frames;           // Frames shown by the scheduler
+  unsigned long forcedFrames;     // Frames shown with an incomplete RGB triplet (max age reached)
+  unsigned long lastLatencyUs;
+  unsigned long maxLatencyUs;
+  unsigned long long totalLatencyUs;
+};
+static LEDFrameStats ledFrameStats = {0, 0, 0, 0, 0};
+
+// Rendered XKey colors per page, stored next to pageData so a page flip is a copy into the strip
+// A page's colors are valid while its generation matches xkeyColorGeneration, which moves on
+// whenever the on/off brightness changes. Status/RGB updates re-render their key in place.
+static uint32_t pageColorCache[127][NUM_XKEYS];
+static uint16_t pageColorGeneration[127] = {0};   // 0 = never rendered
+static uint16_t xkeyColorGeneration = 1;
+static float cachedOnBrightness = -1.0f;          // Brightness the current generation was rendered with
+static float cachedOffBrightness = -1.0f;
+
+struct PageCacheStats {
+  unsigned long hits;             // Page loads copied from the cache
+  unsigned long misses;           // Page loads rendered (first visit or brightness changed)
+};
+static PageCacheStats pageCacheStats = {0, 0};
+
+// LED Effects
+// Effect slots for the current page's XKeys, loaded from pageData when the page is shown or an effect changes
+struct XKeyEffect {
+  uint8_t effect;                 // LEDEffect
+  uint16_t periodMs;              // From the rate, blink/pulse cycle or flash/fade duration
+  uint16_t phaseMs;               // Blink/pulse offset on the shared clock
+  unsigned long startMs;          // millis() the running flash/fade started
+  uint32_t fromColor;             // Color the running flash/fade starts from
+};
+static XKeyEffect xkeyEffects[NUM_XKEYS];
+static XKeyMask effectAnimatingKeys = 0;          // Bit per XKey redrawn every effect frame (blink/pulse, running flash/fade)
+static XKeyMask effectOnKeys = 0;                 // Bit per XKey last rendered on, a flash starts on off → on
+static unsigned long lastEffectFrameMs = 0;
+
+struct LEDEffectStats {
+  unsigned long frames;           // Effect frames drawn
+  unsigned long flashes;          // Flashes started
+  unsigned long fades;            // Fades started (a fade restarted by the rest of its RGB triplet counts once)
+  unsigned long faderLevels;      // Encoder detents shown as a fader level
+  unsigned long lastRenderUs;     // Time to draw one effect frame into the strip buffer
+  unsigned long maxRenderUs;
+  unsigned long long totalRenderUs;
+};
+static LEDEffectStats ledEffectStats = {0, 0, 0, 0, 0, 0, 0};
+
+// Fader level display, drawn over the effects while an XKey encoder turns
+static uint8_t faderLevelValues[NUM_XKEYS] = {0};
+static unsigned long faderLevelMovedMs[NUM_XKEYS] = {0};
+static XKeyMask faderLevelKeys = 0;               // Bit per XKey whose encoder moved within the hold and fade time
+static XKeyMask faderLevelDrawnKeys = 0;          // Keys the last frame drew a level on, redrawn once it has gone
+static int latestFaderLevelKey = -1;              // Bar mode shows the most recently turned key's row
+
+static uint32_t xkeyShownColor(int xkeyIndex, uint32_t base, unsigned long now);
+static void triggerXKeyEffect(int xkeyIndex, const ExecutorStatus* status, uint32_t previous, uint32_t color, unsigned long now);
+static XKeyMask drawAnimatedXKeys(unsigned long now, bool allLevels);
 
 // NeoPixel strip object
 Adafruit_NeoPixel strip(TOTAL_PIXELS, LED_PIN, NEO_RGB + NEO_KHZ800);
@@ -139,6 +186,12 @@ uint32_t getScaledColor(uint8_t red, uint8_t green, uint8_t blue, float brightne
   );
 }
 
+// Set both LEDs of an XKey to a packed strip color
+static inline void setXKeyPixels(int xkeyIndex, uint32_t color) {
+  strip.setPixelColor(hw.xkeys[xkeyIndex].firstPixel, color);
+  strip.setPixelColor(hw.xkeys[xkeyIndex].secondPixel, color);
+}
+
 // Set the color and brightness for a specific X-key's LEDs
 // xkeyIndex: 0-15 for XKey 1-16
 // red, green, blue: 0-127 (MIDI range) - will be scaled to 0-255
@@ -150,68 +203,559 @@ void setXKeyLED(int xkeyIndex, uint8_t red, uint8_t green, uint8_t blue, float b
     return;
   }
   
-  // Use HSV scaling
-  uint32_t scaledColor = getScaledColor(red, green, blue, brightness);
+  // Use HSV scaling, both LEDs for this X-key get the same color
+  setXKeyPixels(xkeyIndex, getScaledColor(red, green, blue, brightness));
+  
+}
+
+// Packed strip color for an executor status (off / offBrightness / onBrightness)
+static uint32_t xkeyStatusColor(const ExecutorStatus* status) {
+  if (!status->isPopulated) {
+    // Key not populated - LEDs off
+    return strip.Color(0, 0, 0);
+  }
+  // Populated keys use offBrightness or onBrightness
+  float brightness = status->isOn ? config.onBrightness : config.offBrightness;
+  return getScaledColor(status->red, status->green, status->blue, brightness);
+}
+
+// Starts a new cache generation when the brightness differs from the one the cache was rendered with
+static void checkXKeyColorGeneration() {
+  if (config.onBrightness == cachedOnBrightness && config.offBrightness == cachedOffBrightness) {
+    return;
+  }
+  cachedOnBrightness = config.onBrightness;
+  cachedOffBrightness = config.offBrightness;
+  if (++xkeyColorGeneration == 0) {
+    // Wrapped, 0 means never rendered
+    for (int page = 0; page < 127; page++) {
+      pageColorGeneration[page] = 0;
+    }
+    xkeyColorGeneration = 1;
+  }
+}
+
+// Set an XKey's LEDs from its executor status on the current page, and keep the page's cache entry in step
+void renderXKeyStatus(int xkeyIndex, const ExecutorStatus* status) {
+  checkXKeyColorGeneration();
+  uint32_t color = xkeyStatusColor(status);
+  uint32_t previous = pageColorCache[currentPage][xkeyIndex];
+  pageColorCache[currentPage][xkeyIndex] = color;
+  
+  // A key with an effect or a fader level shows those, a flash or fade starts from what is shown now
+  if (xkeyEffects[xkeyIndex].effect != LED_EFFECT_NONE || faderLevelKeys != 0) {
+    unsigned long now = millis();
+    triggerXKeyEffect(xkeyIndex, status, previous, color, now);
+    color = xkeyShownColor(xkeyIndex, color, now);
+  }
+  setXKeyPixels(xkeyIndex, color);
+}
+
+// Prefetched data for a page that isn't shown, a page that was never rendered is rendered when loaded
+void cachePageXKeyStatus(int page, int xkeyIndex, const ExecutorStatus* status) {
+  checkXKeyColorGeneration();
+  if (pageColorGeneration[page] == xkeyColorGeneration) {
+    pageColorCache[page][xkeyIndex] = xkeyStatusColor(status);
+  }
+}
+
+// Put a page's XKey colors into the strip buffer, from the cache when it is still valid
+void loadPageLEDs(int page) {
+  checkXKeyColorGeneration();
+  uint32_t* colors = pageColorCache[page];
   
-  // Get the pixels for this X-key
-  int firstPixel = xkeyLEDMap[xkeyIndex].firstPixelIndex;
-  int secondPixel = xkeyLEDMap[xkeyIndex].secondPixelIndex;
+  if (pageColorGeneration[page] != xkeyColorGeneration) {
+    for (int i = 0; i < NUM_XKEYS; i++) {
+      colors[i] = xkeyStatusColor(&pageData[page][i]);
+    }
+    pageColorGeneration[page] = xkeyColorGeneration;
+    pageCacheStats.misses++;
+  } else {
+    pageCacheStats.hits++;
+  }
   
-  // Set both LEDs for this X-key to the same color
-  strip.setPixelColor(firstPixel, scaledColor);
-  strip.setPixelColor(secondPixel, scaledColor);
+  for (int i = 0; i < NUM_XKEYS; i++) {
+    setXKeyPixels(i, colors[i]);
+  }
   
+  // Animated keys start from their effect's current color, not one frame of the plain color
+  if (page == currentPage) {
+    drawAnimatedXKeys(millis(), true);
+  }
 }
 
+// Re-render all XKeys for the current page (brightness changes, leaving adjustment mode)
+// The frame scheduler shows the result, so this is cheap to call on every encoder step
 void updateXKeyLEDs() {
-  static unsigned long lastUpdate = 0;
-  unsigned long now = millis();
-  
   // Don't update XKey LEDs when in sensitivity mode (allow brightness adjustments to show)
   if (sensitivityMode) {
     return;
   }
   
-  // Wait enough time to get all 3 values rgb, for cleaner color changes
-  if (now - lastUpdate < 50) {
+  loadPageLEDs(currentPage);
+  
+  requestLEDFrame();
+}
+
+// Times page flips while scrolling pages 1-8 up and down, rendering every key (the old path)
+// against loading from the page cache. Only the strip buffer is timed, the output is timed once.
+// The cache generations and stats are put back afterwards, so the benchmark leaves the live cache as it was.
+void benchmarkPageFlips(int flips) {
+  const int SCROLL_PAGES = 8;
+  
+  unsigned long startUs = micros();
+  for (int n = 0; n < flips; n++) {
+    int step = n % (2 * SCROLL_PAGES - 2);
+    int page = (step < SCROLL_PAGES) ? step : 2 * SCROLL_PAGES - 2 - step;
+    for (int i = 0; i < NUM_XKEYS; i++) {
+      setXKeyPixels(i, xkeyStatusColor(&pageData[page][i]));
+    }
+  }
+  unsigned long renderUs = micros() - startUs;
+  
+  // Cold cache, the first visit to each page is a miss
+  uint16_t savedGeneration[SCROLL_PAGES];
+  for (int page = 0; page < SCROLL_PAGES; page++) {
+    savedGeneration[page] = pageColorGeneration[page];
+    pageColorGeneration[page] = 0;
+  }
+  PageCacheStats before = pageCacheStats;
+  
+  startUs = micros();
+  for (int n = 0; n < flips; n++) {
+    int step = n % (2 * SCROLL_PAGES - 2);
+    int page = (step < SCROLL_PAGES) ? step : 2 * SCROLL_PAGES - 2 - step;
+    loadPageLEDs(page);
+  }
+  unsigned long cachedUs = micros() - startUs;
+  
+  startUs = micros();
+  strip.show();
+  unsigned long showUs = micros() - startUs;
+  
+  Serial.printf("[LED BENCH] %d page flips over pages 1-%d | Render: %lu us (%.2f us/flip) | Cached: %lu us (%.2f us/flip, %lu misses) | strip.show(): %lu us\n",
+                flips, SCROLL_PAGES, renderUs, renderUs / (float)flips, cachedUs, cachedUs / (float)flips,
+                pageCacheStats.misses - before.misses, showUs);
+  
+  // The re-rendered colors match what a valid entry held, a page that wasn't valid is marked stale again
+  for (int page = 0; page < SCROLL_PAGES; page++) {
+    pageColorGeneration[page] = savedGeneration[page];
+  }
+  
+  // Back to the current page
+  loadPageLEDs(currentPage);
+  pageCacheStats = before;
+  requestLEDFrame();
+}
+
+void showStrip() {
+  strip.show();
+}
+
+// ================================
+// LED FRAME SCHEDULER
+// ================================
+// MIDI handlers render into the strip buffer immediately and mark the XKey here.
+// serviceLEDFrame() shows the strip as soon as no touched XKey is waiting on the rest of an
+// RGB triplet, limited to one frame per LED_FRAME_MIN_INTERVAL_MS, and never later than
+// LED_FRAME_MAX_AGE_MS after the first change (so a lost RGB CC can't hold the frame forever)
+
+static inline void startLEDFrameAge() {
+  if (ledDirtyKeys == 0 && !ledFullFramePending) {
+    ledFrameFirstChangeUs = micros();
+  }
+}
+
+void markXKeyStatusPending(int xkeyIndex, bool expectColor) {
+  if (xkeyIndex < 0 || xkeyIndex >= NUM_XKEYS) return;
+  
+  startLEDFrameAge();
+  XKeyMask keyBit = (XKeyMask)((XKeyMask)1 << xkeyIndex);
+  ledDirtyKeys |= keyBit;
+  
+  // Plugin always follows a newly populated status with the full RGB triplet
+  if (expectColor) {
+    ledIncompleteKeys |= keyBit;
+    xkeyColorParts[xkeyIndex] = 0;
+  }
+}
+
+void markXKeyColorPending(int xkeyIndex, int component) {
+  if (xkeyIndex < 0 || xkeyIndex >= NUM_XKEYS || component < 0 || component > 2) return;
+  
+  startLEDFrameAge();
+  XKeyMask keyBit = (XKeyMask)((XKeyMask)1 << xkeyIndex);
+  ledDirtyKeys |= keyBit;
+  
+  xkeyColorParts[xkeyIndex] |= (uint8_t)(1u << component);
+  if (xkeyColorParts[xkeyIndex] == 0x07) {
+    // Red, green and blue all received
+    xkeyColorParts[xkeyIndex] = 0;
+    ledIncompleteKeys &= (XKeyMask)~keyBit;
+  } else {
+    ledIncompleteKeys |= keyBit;
+  }
+}
+
+void requestLEDFrame() {
+  startLEDFrameAge();
+  ledFullFramePending = true;
+}
+
+void resetLEDFrameTracking() {
+  ledIncompleteKeys = 0;
+  for (int i = 0; i < NUM_XKEYS; i++) {
+    xkeyColorParts[i] = 0;
+  }
+}
+
+void serviceLEDFrame() {
+  if (ledDirtyKeys == 0 && !ledFullFramePending) {
+    return;
+  }
+  
+  // Sensitivity display owns the XKeys, leaving adjustment mode re-renders and requests a frame
+  if (sensitivityMode) {
+    return;
+  }
+  
+  unsigned long nowMs = millis();
+  if (nowMs - lastLEDFrameMs < LED_FRAME_MIN_INTERVAL_MS) {
     return;
   }
-  lastUpdate = now;
   
-  bool ledChanged = false;
+  unsigned long ageUs = micros() - ledFrameFirstChangeUs;
+  bool consistent = (ledIncompleteKeys == 0);
+  if (!consistent && ageUs < LED_FRAME_MAX_AGE_MS * 1000UL) {
+    return;
+  }
   
+  strip.show();
+  lastLEDFrameMs = nowMs;
+  recordFlightEvent16(FLIGHT_LED_FRAME, !consistent, ageUs);
+  
+  ledFrameStats.frames++;
+  ledFrameStats.lastLatencyUs = ageUs;
+  ledFrameStats.totalLatencyUs += ageUs;
+  if (ageUs > ledFrameStats.maxLatencyUs) {
+    ledFrameStats.maxLatencyUs = ageUs;
+  }
+  
+  if (!consistent) {
+    ledFrameStats.forcedFrames++;
+    tracePrintf(TRACE_LED, "[LED] Frame forced after %lu us - incomplete RGB on keys 0x%04lX", ageUs, (unsigned long)ledIncompleteKeys);
+    resetLEDFrameTracking();
+  }
+  
+  ledDirtyKeys = 0;
+  ledFullFramePending = false;
+}
+
+void printLEDFrameStats() {
+  unsigned long avgUs = ledFrameStats.frames ? (unsigned long)(ledFrameStats.totalLatencyUs / ledFrameStats.frames) : 0;
+  Serial.printf("[LED STATS] Frames: %lu | Forced: %lu | Latency us avg: %lu last: %lu max: %lu\n",
+                ledFrameStats.frames, ledFrameStats.forcedFrames,
+                avgUs, ledFrameStats.lastLatencyUs, ledFrameStats.maxLatencyUs);
+  Serial.printf("[LED STATS] Page loads cached: %lu | Rendered: %lu\n",
+                pageCacheStats.hits, pageCacheStats.misses);
+  
+  int animating = 0;
   for (int i = 0; i < NUM_XKEYS; i++) {
-    ExecutorStatus* status = &pageData[currentPage][i];
-    
-    if (!status->isPopulated) {
-      // Key not populated - turn LEDs off
-      setXKeyLED(i, 0, 0, 0, 0.0);
-      ledChanged = true;
-    } else if (status->isPopulated && !status->isOn) {
-      // Key populated but not on - use offBrightness
-      setXKeyLED(i, status->red, status->green, status->blue, config.offBrightness);
-      ledChanged = true;
-    } else if (status->isPopulated && status->isOn) {
-      // Key populated and on - use onBrightness
-      setXKeyLED(i, status->red, status->green, status->blue, config.onBrightness);
-      ledChanged = true;
+    if (effectAnimatingKeys & ((XKeyMask)1 << i)) animating++;
+  }
+  unsigned long avgRenderUs = ledEffectStats.frames ? (unsigned long)(ledEffectStats.totalRenderUs / ledEffectStats.frames) : 0;
+  Serial.printf("[LED EFFECTS] Animating keys: %d | Frames: %lu | Flashes: %lu | Fades: %lu | Fader levels: %lu (display %d) | Draw us avg: %lu last: %lu max: %lu\n",
+                animating, ledEffectStats.frames, ledEffectStats.flashes, ledEffectStats.fades,
+                ledEffectStats.faderLevels, config.faderLevelDisplay,
+                avgRenderUs, ledEffectStats.lastRenderUs, ledEffectStats.maxRenderUs);
+}
+
+// ================================
+// LED EFFECTS
+// ================================
+// Blink, pulse, flash and fade are drawn here over the page's rendered colors (pageColorCache), so
+// the plugin sets an effect once and the wing animates it. serviceLEDEffects() redraws the animating
+// keys once per LED_EFFECT_FRAME_MS and marks them for the frame scheduler like any other change.
+
+static const char* const LED_EFFECT_NAMES[LED_EFFECT_COUNT] = {"NONE", "BLINK", "PULSE", "FLASH", "FADE"};
+
+const char* ledEffectName(int effect) {
+  return (effect >= 0 && effect < LED_EFFECT_COUNT) ? LED_EFFECT_NAMES[effect] : "?";
+}
+
+// Scales a packed strip color, level 0-256
+static inline uint32_t scaleColor(uint32_t color, uint32_t level) {
+  uint32_t r = (((color >> 16) & 0xFF) * level) >> 8;
+  uint32_t g = (((color >> 8) & 0xFF) * level) >> 8;
+  uint32_t b = ((color & 0xFF) * level) >> 8;
+  return strip.Color(r, g, b);
+}
+
+// Mixes two packed strip colors, amount 0 (from) to 256 (to)
+static inline uint32_t blendColor(uint32_t from, uint32_t to, uint32_t amount) {
+  return scaleColor(from, 256 - amount) + scaleColor(to, amount);
+}
+
+static inline XKeyMask xkeyBit(int xkeyIndex) {
+  return (XKeyMask)((XKeyMask)1 << xkeyIndex);
+}
+
+// Color an XKey's effect shows over its base (rendered status) color, a finished flash/fade stops animating
+static uint32_t effectColor(int xkeyIndex, uint32_t base, unsigned long now) {
+  XKeyEffect* fx = &xkeyEffects[xkeyIndex];
+  switch (fx->effect) {
+    case LED_EFFECT_BLINK: {
+      unsigned long position = (now + fx->phaseMs) % fx->periodMs;
+      return (position < fx->periodMs / 2u) ? base : strip.Color(0, 0, 0);
+    }
+    case LED_EFFECT_PULSE: {
+      // Raised cosine from the floor up to the full color and back
+      unsigned long position = (now + fx->phaseMs) % fx->periodMs;
+      float wave = 0.5f - 0.5f * cosf(2.0f * (float)PI * position / fx->periodMs);
+      return scaleColor(base, LED_EFFECT_PULSE_FLOOR + (uint32_t)(wave * (256 - LED_EFFECT_PULSE_FLOOR)));
+    }
+    case LED_EFFECT_FLASH:
+    case LED_EFFECT_FADE: {
+      if (!(effectAnimatingKeys & xkeyBit(xkeyIndex))) {
+        return base;
+      }
+      unsigned long elapsed = now - fx->startMs;
+      if (elapsed >= fx->periodMs) {
+        effectAnimatingKeys &= (XKeyMask)~xkeyBit(xkeyIndex);
+        return base;
+      }
+      return blendColor(fx->fromColor, base, (uint32_t)(elapsed * 256 / fx->periodMs));
     }
+    default:
+      return base;
+  }
+}
+
+// Status or RGB applied to a key with an effect: a flash starts when it turns on, a fade when its color changes
+static void triggerXKeyEffect(int xkeyIndex, const ExecutorStatus* status, uint32_t previous, uint32_t color, unsigned long now) {
+  XKeyEffect* fx = &xkeyEffects[xkeyIndex];
+  XKeyMask keyBit = xkeyBit(xkeyIndex);
+  bool turnedOn = status->isOn && !(effectOnKeys & keyBit);
+  if (status->isOn) {
+    effectOnKeys |= keyBit;
+  } else {
+    effectOnKeys &= (XKeyMask)~keyBit;
   }
   
-  if (ledChanged) {
-    strip.show();
+  if (fx->effect == LED_EFFECT_FLASH && turnedOn) {
+    fx->fromColor = getScaledColor(127, 127, 127, config.onBrightness);
+    fx->startMs = now;
+    effectAnimatingKeys |= keyBit;
+    ledEffectStats.flashes++;
+  } else if (fx->effect == LED_EFFECT_FADE && color != previous) {
+    // A fade that is still running continues from where it is
+    fx->fromColor = effectColor(xkeyIndex, previous, now);
+    if (!(effectAnimatingKeys & keyBit)) {
+      ledEffectStats.fades++;
+    }
+    fx->startMs = now;
+    effectAnimatingKeys |= keyBit;
   }
 }
 
-void showStrip() {
-  strip.show();
+// ================================
+// FADER LEVEL DISPLAY
+// ================================
+// An XKey encoder's value is drawn the moment it turns, over whatever the key shows, and blended
+// back out once the encoder rests. Key mode lights the encoder's XKey at the level's brightness,
+// bar mode fills the XKey's row from the left. Both use the executor's color, white when it has none.
+
+// Level opacity 0-256: full while the encoder moves, then fading out
+static uint32_t faderLevelAmount(int xkeyIndex, unsigned long now) {
+  unsigned long elapsed = now - faderLevelMovedMs[xkeyIndex];
+  if (elapsed < FADER_LEVEL_HOLD_MS) {
+    return 256;
+  }
+  if (elapsed >= FADER_LEVEL_HOLD_MS + FADER_LEVEL_FADE_MS) {
+    return 0;
+  }
+  return 256 - (uint32_t)((elapsed - FADER_LEVEL_HOLD_MS) * 256 / FADER_LEVEL_FADE_MS);
+}
+
+static inline bool sameXKeyRow(int a, int b) {
+  return a / XKEY_COLUMNS == b / XKEY_COLUMNS;
+}
+
+// XKey whose level covers xkeyIndex, -1 for none
+static int faderLevelSource(int xkeyIndex) {
+  if (config.faderLevelDisplay == FADER_LEVEL_BAR) {
+    int source = latestFaderLevelKey;
+    bool covers = source >= 0 && (faderLevelKeys & xkeyBit(source)) && sameXKeyRow(source, xkeyIndex);
+    return covers ? source : -1;
+  }
+  return (faderLevelKeys & xkeyBit(xkeyIndex)) ? xkeyIndex : -1;
+}
+
+// Drops levels that have faded out, returns the keys the remaining ones cover and sets fading to
+// those whose level is blending out (a held level doesn't change between frames)
+static XKeyMask expireFaderLevels(unsigned long now, XKeyMask* fading) {
+  XKeyMask covered = 0;
+  *fading = 0;
+  for (int i = 0; i < NUM_XKEYS; i++) {
+    if ((faderLevelKeys & xkeyBit(i)) && faderLevelAmount(i, now) == 0) {
+      faderLevelKeys &= (XKeyMask)~xkeyBit(i);
+    }
+  }
+  if (faderLevelKeys == 0 || config.faderLevelDisplay == FADER_LEVEL_OFF) {
+    return 0;
+  }
+  for (int i = 0; i < NUM_XKEYS; i++) {
+    int source = faderLevelSource(i);
+    if (source >= 0) {
+      covered |= xkeyBit(i);
+      if (faderLevelAmount(source, now) < 256) {
+        *fading |= xkeyBit(i);
+      }
+    }
+  }
+  return covered;
+}
+
+// Level color of xkeyIndex for the level of source
+static uint32_t faderLevelColor(int xkeyIndex, int source) {
+  const ExecutorStatus* status = &pageData[currentPage][source];
+  uint8_t red = 127, green = 127, blue = 127;
+  if (status->isPopulated && (status->red || status->green || status->blue)) {
+    red = status->red;
+    green = status->green;
+    blue = status->blue;
+  }
+  
+  float level = faderLevelValues[source] / 127.0f;
+  if (config.faderLevelDisplay == FADER_LEVEL_BAR) {
+    // Each key of the row is one eighth of the bar
+    level = constrain(level * XKEY_COLUMNS - (xkeyIndex % XKEY_COLUMNS), 0.0f, 1.0f);
+  }
+  return getScaledColor(red, green, blue, level * config.onBrightness);
+}
+
+// Color an XKey shows: its rendered status, through its effect, under a fader level while its encoder turns
+static uint32_t xkeyShownColor(int xkeyIndex, uint32_t base, unsigned long now) {
+  uint32_t color = effectColor(xkeyIndex, base, now);
+  if (faderLevelKeys != 0 && config.faderLevelDisplay != FADER_LEVEL_OFF) {
+    int source = faderLevelSource(xkeyIndex);
+    if (source >= 0) {
+      color = blendColor(color, faderLevelColor(xkeyIndex, source), faderLevelAmount(source, now));
+    }
+  }
+  return color;
+}
+
+// Draws every animating key into the strip buffer, returns the keys drawn
+// Keys under a held fader level are only redrawn when allLevels is set (the level changed)
+static XKeyMask drawAnimatedXKeys(unsigned long now, bool allLevels) {
+  XKeyMask fading;
+  XKeyMask covered = expireFaderLevels(now, &fading);
+  XKeyMask gone = faderLevelDrawnKeys & (XKeyMask)~covered;
+  XKeyMask drawn = effectAnimatingKeys | (allLevels ? covered : fading) | gone;
+  faderLevelDrawnKeys = covered;
+  
+  const uint32_t* colors = pageColorCache[currentPage];
+  for (int i = 0; i < NUM_XKEYS; i++) {
+    if (drawn & xkeyBit(i)) {
+      setXKeyPixels(i, xkeyShownColor(i, colors[i], now));
+    }
+  }
+  return drawn;
+}
+
+void showFaderLevel(int xkeyIndex, int value) {
+  if (config.faderLevelDisplay == FADER_LEVEL_OFF || sensitivityMode || xkeyIndex < 0 || xkeyIndex >= NUM_XKEYS) {
+    return;
+  }
+  
+  faderLevelValues[xkeyIndex] = (uint8_t)constrain(value, 0, 127);
+  faderLevelMovedMs[xkeyIndex] = millis();
+  faderLevelKeys |= xkeyBit(xkeyIndex);
+  latestFaderLevelKey = xkeyIndex;
+  ledEffectStats.faderLevels++;
+  
+  // Drawn now, the frame scheduler shows it on the next allowed frame
+  XKeyMask drawn = drawAnimatedXKeys(faderLevelMovedMs[xkeyIndex], true);
+  startLEDFrameAge();
+  ledDirtyKeys |= drawn;
+}
+
+static void loadXKeyEffect(int xkeyIndex, const ExecutorStatus* status) {
+  XKeyEffect* fx = &xkeyEffects[xkeyIndex];
+  XKeyMask keyBit = xkeyBit(xkeyIndex);
+  fx->effect = status->effect >> 4;
+  if (fx->effect >= LED_EFFECT_COUNT) {
+    fx->effect = LED_EFFECT_NONE;
+  }
+  fx->periodMs = LED_EFFECT_PERIODS_MS[status->effect & 0x0F];
+  fx->phaseMs = (uint16_t)((uint32_t)status->effectPhase * fx->periodMs / 128);
+  
+  // Blink and pulse always animate, flash and fade wait for their key to change
+  if (fx->effect == LED_EFFECT_BLINK || fx->effect == LED_EFFECT_PULSE) {
+    effectAnimatingKeys |= keyBit;
+  } else {
+    effectAnimatingKeys &= (XKeyMask)~keyBit;
+  }
+  if (status->isOn) {
+    effectOnKeys |= keyBit;
+  } else {
+    effectOnKeys &= (XKeyMask)~keyBit;
+  }
+}
+
+void loadPageEffects(int page) {
+  for (int i = 0; i < NUM_XKEYS; i++) {
+    loadXKeyEffect(i, &pageData[page][i]);
+  }
+  // Levels belonged to the old page's faders, the page load redraws every key
+  faderLevelKeys = 0;
+  faderLevelDrawnKeys = 0;
+}
+
+void setXKeyEffect(int xkeyIndex, const ExecutorStatus* status) {
+  if (xkeyIndex < 0 || xkeyIndex >= NUM_XKEYS) return;
+  
+  loadXKeyEffect(xkeyIndex, status);
+  setXKeyPixels(xkeyIndex, xkeyShownColor(xkeyIndex, pageColorCache[currentPage][xkeyIndex], millis()));
+  markXKeyStatusPending(xkeyIndex, false);
+}
+
+void serviceLEDEffects() {
+  if ((effectAnimatingKeys == 0 && faderLevelKeys == 0 && faderLevelDrawnKeys == 0) || sensitivityMode) {
+    return;
+  }
+  
+  unsigned long now = millis();
+  if (now - lastEffectFrameMs < LED_EFFECT_FRAME_MS) {
+    return;
+  }
+  lastEffectFrameMs = now;
+  
+  unsigned long startUs = micros();
+  XKeyMask drawn = drawAnimatedXKeys(now, false);
+  unsigned long renderUs = micros() - startUs;
+  if (drawn == 0) {
+    return;  // Only held fader levels, nothing moved
+  }
+  
+  // Shown by the frame scheduler, together with any status changes of the same pass
+  startLEDFrameAge();
+  ledDirtyKeys |= drawn;
+  
+  ledEffectStats.frames++;
+  ledEffectStats.lastRenderUs = renderUs;
+  ledEffectStats.totalRenderUs += renderUs;
+  if (renderUs > ledEffectStats.maxRenderUs) {
+    ledEffectStats.maxRenderUs = renderUs;
+  }
 }
 
 
 // XKey startup fade sequence with rainbow wave effect AND bouncing
 void xkeyFadeSequenceBounce(unsigned long STAGGER_DELAY, unsigned long COLOR_CYCLE_TIME, int cycles, int bounces) {
   
-  const int NUM_GROUPS = 8;  // 8 groups of paired XKeys
+  const int NUM_GROUPS = XKEY_COLUMNS;  // One group per XKey column (V0.2: 8 groups of paired XKeys)
   unsigned long startTime = millis();
   bool animationComplete = false;
   
@@ -283,9 +827,7 @@ void xkeyFadeSequenceBounce(unsigned long STAGGER_DELAY, unsigned long COLOR_CYC
       if (now >= groupStartTime) {
         unsigned long elapsed = now - groupStartTime;
         
-        // Calculate which XKeys belong to this group
-        int xkey1 = group;         // XKeys 0-7 (representing 1-8)
-        int xkey2 = group + 8;     // XKeys 8-15 (representing 9-16)
+        // XKeys in this group are the column's key in every row (V0.2: XKey N and N+8)
         
         if (elapsed < COLOR_CYCLE_TIME) {
           // Rainbow color wave is active on this group
@@ -321,9 +863,10 @@ void xkeyFadeSequenceBounce(unsigned long STAGGER_DELAY, unsigned long COLOR_CYC
           
           float finalBrightness = breatheValue * fadeProgress;
           
-          // Set both XKeys in this group to the same color
-          setXKeyLED(xkey1, rainbowRed, rainbowGreen, rainbowBlue, finalBrightness);
-          setXKeyLED(xkey2, rainbowRed, rainbowGreen, rainbowBlue, finalBrightness);
+          // Set all XKeys in this group to the same color
+          for (int row = 0; row < XKEY_ROWS; row++) {
+            setXKeyLED(group + row * XKEY_COLUMNS, rainbowRed, rainbowGreen, rainbowBlue, finalBrightness);
+          }
           
         } else {
           // Wave has passed, fade out with color shift to original colors
@@ -336,9 +879,9 @@ void xkeyFadeSequenceBounce(unsigned long STAGGER_DELAY, unsigned long COLOR_CYC
             // Fade to original colors while dimming
             float fadeProgress = fadeOutTime / (float)FADE_OUT_DURATION;
             
-            // Process both XKeys in the group
-            for (int xkeyOffset = 0; xkeyOffset < 2; xkeyOffset++) {
-              int xkeyIndex = (xkeyOffset == 0) ? xkey1 : xkey2;
+            // Process all XKeys in the group
+            for (int row = 0; row < XKEY_ROWS; row++) {
+              int xkeyIndex = group + row * XKEY_COLUMNS;
               
               // Blend to original color
               uint8_t targetRed = (uint8_t)((originalStates[xkeyIndex].red * 2) * fadeProgress);
@@ -352,19 +895,19 @@ void xkeyFadeSequenceBounce(unsigned long STAGGER_DELAY, unsigned long COLOR_CYC
             }
           } else {
             // Completely finished - restore original states
-            setXKeyLED(xkey1, originalStates[xkey1].red, originalStates[xkey1].green, 
-                      originalStates[xkey1].blue, originalStates[xkey1].brightness);
-            setXKeyLED(xkey2, originalStates[xkey2].red, originalStates[xkey2].green, 
-                      originalStates[xkey2].blue, originalStates[xkey2].brightness);
+            for (int row = 0; row < XKEY_ROWS; row++) {
+              int xkeyIndex = group + row * XKEY_COLUMNS;
+              setXKeyLED(xkeyIndex, originalStates[xkeyIndex].red, originalStates[xkeyIndex].green, 
+                        originalStates[xkeyIndex].blue, originalStates[xkeyIndex].brightness);
+            }
           }
         }
       } else {
         // Group hasn't started yet
         animationComplete = false;
-        int xkey1 = group;
-        int xkey2 = group + 8;
-        setXKeyLED(xkey1, 0, 0, 0, 0.0);
-        setXKeyLED(xkey2, 0, 0, 0, 0.0);
+        for (int row = 0; row < XKEY_ROWS; row++) {
+          setXKeyLED(group + row * XKEY_COLUMNS, 0, 0, 0, 0.0);
+        }
       }
     }
     
@@ -388,8 +931,8 @@ void xkeyFadeSequenceBounce(unsigned long STAGGER_DELAY, unsigned long COLOR_CYC
 
 
 void updateSensitivityLEDs() {
-  // Show relative sensitivity on XKeys 1-8 (green)
-  for (int i = 0; i < 8; i++) {
+  // Show relative sensitivity on the first row, XKeys 1-8 (green)
+  for (int i = 0; i < XKEY_COLUMNS; i++) {
     if (i < config.relativeEncoderSensitivity) {
       setXKeyLED(i, 0, 127, 0, config.onBrightness);      // Green for active levels
     } else {
@@ -397,14 +940,19 @@ void updateSensitivityLEDs() {
     }
   }
   
-  // Show absolute sensitivity on XKeys 9-16 (blue)
-  for (int i = 8; i < 16; i++) {
-    if ((i - 8) < config.absoluteEncoderSensitivity) {
-      setXKeyLED(i, 0, 0, 127, config.onBrightness);      // Blue for active levels
+  // Show absolute sensitivity on the second row, XKeys 9-16 (blue)
+  for (int i = 0; i < XKEY_COLUMNS; i++) {
+    if (i < config.absoluteEncoderSensitivity) {
+      setXKeyLED(XKEY_COLUMNS + i, 0, 0, 127, config.onBrightness);      // Blue for active levels
     } else {
-      setXKeyLED(i, 0, 0, 0, 0.0);                 // Off for inactive levels
+      setXKeyLED(XKEY_COLUMNS + i, 0, 0, 0, 0.0);                 // Off for inactive levels
     }
   }
   
+  // Any further rows are off
+  for (int i = 2 * XKEY_COLUMNS; i < NUM_XKEYS; i++) {
+    setXKeyLED(i, 0, 0, 0, 0.0);
+  }
+  
   showStrip();
 }
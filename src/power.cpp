@@ -0,0 +1,153 @@
+#include "power.h"
+#include "midi.h"
+#include "utils.h"
+#ifdef NATIVE_BUILD
+#include "NativeBridge.h"
+#endif
+
+// ================================
+// LOW POWER IDLE
+// ================================
+// A loop pass that leaves nothing pending (receive ring, outgoing queue, serial input or dump) ends
+// with the core waiting for an event (WFE) instead of spinning into the next pass. Any interrupt ends
+// the wait: USB, the encoder pins (Encoder library), the button pins (attached below only to wake)
+// and the 1ms SysTick behind millis(), so work timed in milliseconds (LED frames, held feedback,
+// credit keepalives) still runs on the same tick it did before.
+// beginLoopPass() clears the event register and every interrupt return sets it again, so an interrupt
+// that lands after its input was polled makes the WFE fall straight through to the next pass.
+// The native build waits on the bridge socket instead.
+
+struct IdleStats {
+  unsigned long sleeps;              // Passes that ended waiting for an interrupt
+  unsigned long busyPasses;          // Passes that ended with work pending
+  unsigned long windowBusyPermille;  // Last full IDLE_STATS_WINDOW_MS window
+  unsigned long maxBusyPermille;
+  uint64_t elapsedUs;                // Closed windows since boot
+  uint64_t sleepUs;
+  unsigned long wakeInputs;          // Wakes whose following pass handled an input
+  unsigned long lastLatencyUs;       // Wake to input handled
+  unsigned long maxLatencyUs;
+  uint64_t totalLatencyUs;
+};
+static IdleStats idleStats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+static bool sleepEnabled = IDLE_SLEEP_DEFAULT;
+static unsigned long windowStartUs = 0;
+static unsigned long windowSleepUs = 0;
+static unsigned long wakeUs = 0;           // micros() once the waking interrupt has run
+static bool awaitingInput = false;         // Set for the pass right after a wake
+
+#ifndef NATIVE_BUILD
+// Buttons are polled by handleButtons(), the interrupt only has to end the WFE
+static void buttonWakeISR() {
+}
+#endif
+
+void initializeIdle() {
+#ifndef NATIVE_BUILD
+  // RUN mode: WFE only gates the core clock, WAIT/STOP would also stop clocks USB needs
+  CCM_CLPCR &= ~CCM_CLPCR_LPM(3);
+
+  for (int i = 0; i < N_BUTTONS; i++) {
+    attachInterrupt(hw.buttonPins[i], buttonWakeISR, CHANGE);
+  }
+#endif
+  windowStartUs = micros();
+}
+
+void beginLoopPass() {
+#ifndef NATIVE_BUILD
+  // SEV sets the event register and WFE consumes it without sleeping, leaving it clear for this pass
+  asm volatile("sev\n\twfe" ::: "memory");
+#endif
+}
+
+static bool workPending() {
+  return midiWorkPending() || serialWorkPending();
+}
+
+static void closeStatsWindow(unsigned long now) {
+  unsigned long elapsed = now - windowStartUs;
+  if (elapsed < IDLE_STATS_WINDOW_MS * 1000) {
+    return;
+  }
+
+  unsigned long sleep = min(windowSleepUs, elapsed);
+  idleStats.windowBusyPermille = (unsigned long)((uint64_t)(elapsed - sleep) * 1000 / elapsed);
+  if (idleStats.windowBusyPermille > idleStats.maxBusyPermille) {
+    idleStats.maxBusyPermille = idleStats.windowBusyPermille;
+  }
+  idleStats.elapsedUs += elapsed;
+  idleStats.sleepUs += sleep;
+
+  windowStartUs = now;
+  windowSleepUs = 0;
+}
+
+void idleUntilWork() {
+  awaitingInput = false;
+  unsigned long now = micros();
+  closeStatsWindow(now);
+
+  if (!sleepEnabled) {
+    return;
+  }
+  if (workPending()) {
+    idleStats.busyPasses++;
+    return;
+  }
+
+#ifdef NATIVE_BUILD
+  nativeBridgeIdle();
+#else
+  asm volatile("dsb\n\twfe" ::: "memory");
+#endif
+
+  wakeUs = micros();
+  windowSleepUs += wakeUs - now;
+  idleStats.sleeps++;
+  awaitingInput = true;
+}
+
+void noteInputHandled() {
+  if (!awaitingInput) {
+    return;
+  }
+  awaitingInput = false;
+
+  unsigned long latency = micros() - wakeUs;
+  idleStats.wakeInputs++;
+  idleStats.lastLatencyUs = latency;
+  idleStats.totalLatencyUs += latency;
+  if (latency > idleStats.maxLatencyUs) {
+    idleStats.maxLatencyUs = latency;
+  }
+}
+
+void setIdleSleep(bool enabled) {
+  sleepEnabled = enabled;
+}
+
+bool idleSleepEnabled() {
+  return sleepEnabled;
+}
+
+void printIdleStats() {
+  unsigned long sinceBootPermille = idleStats.elapsedUs > 0
+    ? (unsigned long)((idleStats.elapsedUs - idleStats.sleepUs) * 1000 / idleStats.elapsedUs) : 0;
+
+  Serial.printf("[IDLE] Sleep: %s | CPU busy: %lu.%lu%% (last %lu ms), peak %lu.%lu%%, since boot %lu.%lu%% | Sleeps: %lu | Passes with work pending: %lu\n",
+                sleepEnabled ? "ON" : "OFF",
+                idleStats.windowBusyPermille / 10, idleStats.windowBusyPermille % 10, IDLE_STATS_WINDOW_MS,
+                idleStats.maxBusyPermille / 10, idleStats.maxBusyPermille % 10,
+                sinceBootPermille / 10, sinceBootPermille % 10,
+                idleStats.sleeps, idleStats.busyPasses);
+
+  if (idleStats.wakeInputs > 0) {
+    Serial.printf("[IDLE] Wake to input handled: %lu wakes | last %lu us, avg %lu us, max %lu us\n",
+                  idleStats.wakeInputs, idleStats.lastLatencyUs,
+                  (unsigned long)(idleStats.totalLatencyUs / idleStats.wakeInputs), idleStats.maxLatencyUs);
+  } else {
+    Serial.println("[IDLE] Wake to input handled: no input woken from sleep yet");
+  }
+}
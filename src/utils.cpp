@@ -1,5 +1,17 @@
 #include "utils.h"
 #include "config.h"
+#include "neopixel.h"
+#include "midi.h"
+#include "encoders.h"
+#include "watchdog.h"
+#include "flightRecorder.h"
+#include "power.h"
+#ifdef NATIVE_BUILD
+#include "NativeBridge.h"
+#endif
+#include <stddef.h>
+#include <math.h>
+#include <strings.h>
 
 //================================
 // DEBUG SETTINGS
@@ -11,10 +23,26 @@
 #endif
 
 
+// Trace categories shown while debugMode is on, toggled with the TRACE serial command
+uint16_t traceMask = TRACE_ALL;
+
+
 //================================
 // DEBUG FUNCTIONS
 //================================
 
+static void debugVPrintf(const char* format, va_list args) {
+  char buffer[128];
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  
+  // Check if the format string already ends with a newline
+  size_t len = strlen(format);
+  if (len > 0 && format[len-1] == '\n') {
+    Serial.print(buffer); // Already has newline
+  } else {
+    Serial.println(buffer); // Add newline
+  }
+}
 
 void debugPrint(const char* message) {
   if (debugMode) {
@@ -24,86 +52,464 @@ void debugPrint(const char* message) {
 
 void debugPrintf(const char* format, ...) {
   if (debugMode) {
-    char buffer[128];
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    debugVPrintf(format, args);
     va_end(args);
-    
-    // Check if the format string already ends with a newline
-    size_t len = strlen(format);
-    if (len > 0 && format[len-1] == '\n') {
-      Serial.print(buffer); // Already has newline
-    } else {
-      Serial.println(buffer); // Add newline
-    }
   }
 }
 
+// Per message debug output, checked before formatting so disabled categories cost nothing
+void tracePrintf(uint16_t category, const char* format, ...) {
+  if (!debugMode || !(traceMask & category)) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  debugVPrintf(format, args);
+  va_end(args);
+}
+
 
 //================================
-// UPLOAD Function 
+// SERIAL COMMANDS
 //================================
-//Upload without pressing button, using python script, takes one second try
+// Lines are collected into a fixed buffer, at most SERIAL_CHARS_PER_POLL characters and one
+// command per call, so a flood of serial input can't stall the loop. Nothing is allocated.
+// Upload without pressing button (IDENTIFY / REBOOT_*), used by teensy_auto_upload*.py
+
+static char serialLine[SERIAL_COMMAND_MAX_LENGTH + 1];
+static int serialLineLength = 0;
+static bool serialLineOverflow = false;     // Rest of an overlong line is discarded
+
+// PAGE dumps one XKey per call, only while the serial TX buffer has room
+static int pageDumpIndex = -1;              // Page being dumped (0-126), -1 when idle
+static int pageDumpNextKey = 0;
+
+static bool serviceSerialOutput();
+
 void checkSerialForReboot() {
-    static String commandBuffer = "";
+  // Commands wait in the RX buffer until a running dump is finished
+  if (serviceSerialOutput()) {
+    return;
+  }
+  
+  for (int n = 0; n < SERIAL_CHARS_PER_POLL && Serial.available() > 0; n++) {
+    char c = (char)Serial.read();
     
-    // Read all available characters and buffer them
-    while (Serial.available()) {
-        char c = Serial.read();
-        if (c == '\n' || c == '\r') {
-            // End of command received, process it
-            commandBuffer.trim(); // Remove any whitespace
-            String cmd = commandBuffer;
-            commandBuffer = ""; // Clear buffer for next command
-            
-            // Process the complete command
-            if (cmd.length() > 0) {
-                processSerialCommand(cmd);
-            }
-            return;
-        } else {
-            // Add character to buffer
-            commandBuffer += c;
-        }
+    if (c == '\n' || c == '\r') {
+      bool overflow = serialLineOverflow;
+      serialLine[serialLineLength] = '\0';
+      serialLineLength = 0;
+      serialLineOverflow = false;
+      
+      if (overflow) {
+        Serial.printf("[SERIAL] Command longer than %d characters ignored\n", SERIAL_COMMAND_MAX_LENGTH);
+      } else {
+        processSerialCommand(serialLine);
+      }
+      return;
     }
+    
+    if (serialLineLength < SERIAL_COMMAND_MAX_LENGTH) {
+      serialLine[serialLineLength++] = c;
+    } else {
+      serialLineOverflow = true;
+    }
+  }
+}
+
+bool serialWorkPending() {
+  return Serial.available() > 0 || pageDumpIndex >= 0 || flightRecorderPaused;
+}
+
+// ---- Command handlers ----
+
+static void printIdent(const char* tag, const char* suffix) {
+  Serial.printf("[%s] %s v%s%s\n", tag, PROJECT_NAME, PROJECT_VERSION, suffix);
+  Serial.flush();
 }
 
 // Send identiy so we can update a specific teensy when more than one is plugged in, used with teensy_auto_upload_multi.py
-void processSerialCommand(String cmd) {
-    if (cmd == "IDENTIFY") {
-        Serial.print("[IDENT] ");
-        Serial.print(PROJECT_NAME);
-        Serial.print(" v");
-        Serial.println(PROJECT_VERSION);
-        Serial.flush();
-        
-    } else if (cmd == "REBOOT_BOOTLOADER") {
-        Serial.print("[REBOOT] ");
-        Serial.print(PROJECT_NAME);
-        Serial.print(" v");
-        Serial.print(PROJECT_VERSION);
-        Serial.println(" entering bootloader...");
-        Serial.flush(); // Important: ensure message is sent before reboot
-        delay(100);
-        
-        // This is the correct method for ALL Teensy models
-        _reboot_Teensyduino_();
-        
-    } else if (cmd == "REBOOT_NORMAL") {
-        Serial.print("[REBOOT] ");
-        Serial.print(PROJECT_NAME);
-        Serial.print(" v");
-        Serial.print(PROJECT_VERSION);
-        Serial.println(" normal reboot requested...");
-        Serial.flush();
-        delay(100);
-        
-        // Normal restart using ARM AIRCR register
-        SCB_AIRCR = 0x05FA0004;
-        
+static void commandIdentify(int argc, char* argv[]) {
+  printIdent("IDENT", "");
+}
+
+static void commandRebootBootloader(int argc, char* argv[]) {
+  printIdent("REBOOT", " entering bootloader...");  // Important: ensure message is sent before reboot
+  delay(100);
+  
+  // This is the correct method for ALL Teensy models
+  _reboot_Teensyduino_();
+}
+
+static void commandRebootNormal(int argc, char* argv[]) {
+  printIdent("REBOOT", " normal reboot requested...");
+  delay(100);
+  
+  // Normal restart using ARM AIRCR register
+  SCB_AIRCR = 0x05FA0004;
+}
+
+static void commandLEDStats(int argc, char* argv[]) {
+  // LED frame scheduler latency (first change to strip show)
+  printLEDFrameStats();
+}
+
+// LED_BENCH [flips] - page flip render time, uncached against the page cache
+static void commandLEDBench(int argc, char* argv[]) {
+  int flips = 200;
+  if (argc > 1) {
+    char* end;
+    flips = (int)strtol(argv[1], &end, 10);
+    if (*end != '\0' || flips < 1 || flips > 2000) {
+      Serial.println("[SERIAL] LED_BENCH expects 1-2000 flips");
+      return;
+    }
+  }
+  benchmarkPageFlips(flips);
+}
+
+static void commandMidiStats(int argc, char* argv[]) {
+  // Receive ring depth and credit advertisements
+  printMidiStats();
+}
+
+static void commandStats(int argc, char* argv[]) {
+  printLEDFrameStats();
+  printMidiStats();
+  printEncoderStats();
+  printWatchdogStats();
+  printIdleStats();
+#ifdef NATIVE_BUILD
+  const NativeBridgeStats& bridge = nativeBridgeStats();
+  Serial.printf("[BRIDGE] Received: %lu messages (%lu bytes) | Dropped (queue full): %lu | Sent: %lu | Injected detents: %lu buttons: %lu\n",
+                bridge.rxMessages, bridge.rxBytes, bridge.droppedMessages, bridge.txMessages,
+                bridge.injectedDetents, bridge.injectedButtons);
+#endif
+}
+
+// WATCHDOG [STALL ms] - loop stall statistics and post-mortems, STALL blocks the loop to test them
+// A stall of WATCHDOG_TIMEOUT_MS or more resets the Teensy through the hardware watchdog
+static void commandWatchdog(int argc, char* argv[]) {
+  if (argc >= 3 && strcasecmp(argv[1], "STALL") == 0) {
+    char* end;
+    long ms = strtol(argv[2], &end, 10);
+    if (*end != '\0' || ms < 1 || ms > 10000) {
+      Serial.println("[SERIAL] WATCHDOG STALL expects 1-10000 ms");
+      return;
+    }
+    Serial.printf("[WATCHDOG] Stalling loop for %ld ms\n", ms);
+    Serial.flush();
+    delay(ms);
+    return;
+  }
+  printWatchdogStats();
+}
+
+// PAGE [n] - executor cache for page n (1-127), current page by default
+static void commandPage(int argc, char* argv[]) {
+  int page = currentPage + 1;
+  if (argc > 1) {
+    char* end;
+    page = (int)strtol(argv[1], &end, 10);
+    if (*end != '\0' || page < 1 || page > 127) {
+      Serial.println("[SERIAL] PAGE expects a page number 1-127");
+      return;
+    }
+  }
+  
+  Serial.printf("[PAGE %d]%s Digests:", page, (page - 1 == currentPage) ? " (current)" : "");
+  for (int group = 0; group < PAGE_DIGEST_GROUPS; group++) {
+    Serial.printf(" %d", pageGroupDigest(page - 1, group));
+  }
+  Serial.println();
+  pageDumpIndex = page - 1;
+  pageDumpNextKey = 0;
+}
+
+// EFFECT n NONE|BLINK|PULSE|FLASH|FADE [rate 0-15] [phase 0-127] - LED effect of XKey n on the current page
+static void commandEffect(int argc, char* argv[]) {
+  int effect = -1;
+  if (argc >= 3) {
+    for (int i = 0; i < LED_EFFECT_COUNT; i++) {
+      if (strcasecmp(argv[2], ledEffectName(i)) == 0) {
+        effect = i;
+      }
+    }
+  }
+  int xkey = (argc >= 2) ? atoi(argv[1]) : 0;
+  int rate = (argc >= 4) ? atoi(argv[3]) : 0;
+  int phase = (argc >= 5) ? atoi(argv[4]) : 0;
+  if (xkey < 1 || xkey > NUM_XKEYS || effect < 0 || rate < 0 || rate > 15 || phase < 0 || phase > 127) {
+    Serial.printf("[SERIAL] EFFECT expects an XKey 1-%d, NONE|BLINK|PULSE|FLASH|FADE, rate 0-15 and phase 0-127\n", NUM_XKEYS);
+    return;
+  }
+  
+  setExecutorEffect(currentPage, xkey - 1, (byte)(effect * 16 + rate), (byte)phase);
+  Serial.printf("[EFFECT] Page %d XKey %d: %s rate %d (%u ms) phase %d\n", currentPage + 1, xkey,
+                ledEffectName(effect), rate, LED_EFFECT_PERIODS_MS[rate], phase);
+}
+
+// Returns true while a dump is still running
+static bool serviceSerialOutput() {
+  if (serviceFlightRecorderDump()) {
+    return true;
+  }
+  if (pageDumpIndex < 0) {
+    return false;
+  }
+  if (Serial.availableForWrite() < 64) {
+    return true;
+  }
+  
+  int i = pageDumpNextKey++;
+  const ExecutorStatus* status = &pageData[pageDumpIndex][i];
+  Serial.printf("  XKey %2d (Exec %d): Pop=%s On=%s RGB=(%d,%d,%d)",
+                i + 1, hw.xkeys[i].executor,
+                status->isPopulated ? "YES" : "NO", status->isOn ? "YES" : "NO",
+                status->red, status->green, status->blue);
+  if (status->hasFaderValue) {
+    Serial.printf(" Fader=%d", status->faderValue);
+  }
+  if (status->effect >> 4) {
+    Serial.printf(" Effect=%s rate %d phase %d", ledEffectName(status->effect >> 4), status->effect & 0x0F, status->effectPhase);
+  }
+  Serial.println();
+  
+  if (pageDumpNextKey >= NUM_XKEYS) {
+    pageDumpIndex = -1;
+  }
+  return true;
+}
+
+// RECORDER [DUMP | CLEAR] - flight recorder status, DUMP sends the ring as binary
+static void commandRecorder(int argc, char* argv[]) {
+  if (argc >= 2 && strcasecmp(argv[1], "DUMP") == 0) {
+    startFlightRecorderDump();
+    return;
+  }
+  if (argc >= 2 && strcasecmp(argv[1], "CLEAR") == 0) {
+    clearFlightRecorder();
+  }
+  printFlightRecorderStats();
+}
+
+// IDLE [ON|OFF] - low power idle between loop passes, CPU busy percentage and wake latency
+static void commandIdle(int argc, char* argv[]) {
+  if (argc >= 2) {
+    setIdleSleep(strcasecmp(argv[1], "ON") == 0);
+  }
+  printIdleStats();
+}
+
+// Config fields reachable with CONFIG GET/SET
+struct ConfigField {
+  const char* name;
+  bool isFloat;
+  size_t offset;
+  float minValue;
+  float maxValue;
+};
+
+static const ConfigField CONFIG_FIELDS[] = {
+  {"relativeEncoderSensitivity", false, offsetof(ConfigData, relativeEncoderSensitivity), 1, 8},
+  {"absoluteEncoderSensitivity", false, offsetof(ConfigData, absoluteEncoderSensitivity), 1, 8},
+  {"onBrightness",               true,  offsetof(ConfigData, onBrightness),               0, 1},
+  {"offBrightness",              true,  offsetof(ConfigData, offBrightness),              0, 1},
+  {"logoBrightness",             true,  offsetof(ConfigData, logoBrightness),             0, 1},
+  {"faderLevelDisplay",          false, offsetof(ConfigData, faderLevelDisplay),          0, 2},
+  {"midiChannelBase",            false, offsetof(ConfigData, midiChannelBase),            0, 12},
+};
+const int NUM_CONFIG_FIELDS = sizeof(CONFIG_FIELDS) / sizeof(CONFIG_FIELDS[0]);
+
+static void printConfigField(const ConfigField* field) {
+  const uint8_t* base = (const uint8_t*)&config;
+  if (field->isFloat) {
+    Serial.printf("[CONFIG] %s = %.2f\n", field->name, *(const float*)(base + field->offset));
+  } else {
+    Serial.printf("[CONFIG] %s = %d\n", field->name, *(const int*)(base + field->offset));
+  }
+}
+
+static const ConfigField* findConfigField(const char* name) {
+  for (int i = 0; i < NUM_CONFIG_FIELDS; i++) {
+    if (strcasecmp(CONFIG_FIELDS[i].name, name) == 0) {
+      return &CONFIG_FIELDS[i];
+    }
+  }
+  Serial.printf("[SERIAL] Unknown config field: %s\n", name);
+  return nullptr;
+}
+
+// Show the new brightness right away, same as the adjustment encoders
+static void applyConfig() {
+  updateXKeyLEDs();
+  setLogoPixels(127, 64, 0, config.logoBrightness);
+}
+
+// CONFIG [GET name | SET name value | SAVE | DEFAULTS]
+static void commandConfig(int argc, char* argv[]) {
+  if (argc < 2 || (strcasecmp(argv[1], "GET") == 0 && argc < 3)) {
+    for (int i = 0; i < NUM_CONFIG_FIELDS; i++) {
+      printConfigField(&CONFIG_FIELDS[i]);
+    }
+    
+  } else if (strcasecmp(argv[1], "GET") == 0) {
+    const ConfigField* field = findConfigField(argv[2]);
+    if (field) printConfigField(field);
+    
+  } else if (strcasecmp(argv[1], "SET") == 0 && argc >= 4) {
+    const ConfigField* field = findConfigField(argv[2]);
+    if (!field) return;
+    
+    char* end;
+    float value = strtof(argv[3], &end);
+    // Written so NaN fails the range check, every comparison with it is false
+    if (end == argv[3] || *end != '\0' || !(value >= field->minValue && value <= field->maxValue)) {
+      Serial.printf("[SERIAL] %s must be %g-%g\n", field->name, field->minValue, field->maxValue);
+      return;
+    }
+    if (!field->isFloat && value != floorf(value)) {
+      Serial.printf("[SERIAL] %s must be a whole number\n", field->name);
+      return;
+    }
+    
+    uint8_t* base = (uint8_t*)&config;
+    if (field->isFloat) {
+      *(float*)(base + field->offset) = value;
     } else {
-        Serial.print("[REBOOT] Unknown command: ");
-        Serial.println(cmd);
+      *(int*)(base + field->offset) = (int)value;
     }
-}
\ No newline at end of file
+    applyConfig();
+    printConfigField(field);
+    
+  } else if (strcasecmp(argv[1], "SAVE") == 0) {
+    saveConfig();
+    Serial.println("[CONFIG] Saved");
+    
+  } else if (strcasecmp(argv[1], "DEFAULTS") == 0) {
+    resetConfigToDefaults();
+    applyConfig();
+    Serial.println("[CONFIG] Defaults restored (CONFIG SAVE to keep)");
+    
+  } else {
+    Serial.println("[SERIAL] CONFIG [GET name | SET name value | SAVE | DEFAULTS]");
+  }
+}
+
+struct TraceName {
+  const char* name;
+  uint16_t category;
+};
+
+static const TraceName TRACE_NAMES[] = {
+  {"MIDI",    TRACE_MIDI_IN},
+  {"STATUS",  TRACE_STATUS},
+  {"PAGE",    TRACE_PAGE},
+  {"ENCODER", TRACE_ENCODER},
+  {"BUTTON",  TRACE_BUTTON},
+  {"LED",     TRACE_LED},
+  {"ALL",     TRACE_ALL},
+};
+const int NUM_TRACE_NAMES = sizeof(TRACE_NAMES) / sizeof(TRACE_NAMES[0]);
+
+// TRACE [category ON|OFF] - lists categories without arguments
+static void commandTrace(int argc, char* argv[]) {
+  if (argc >= 3) {
+    bool on = (strcasecmp(argv[2], "ON") == 0);
+    if (!on && strcasecmp(argv[2], "OFF") != 0) {
+      Serial.println("[SERIAL] TRACE category ON|OFF");
+      return;
+    }
+    
+    int i = 0;
+    while (i < NUM_TRACE_NAMES && strcasecmp(TRACE_NAMES[i].name, argv[1]) != 0) i++;
+    if (i == NUM_TRACE_NAMES) {
+      Serial.printf("[SERIAL] Unknown trace category: %s\n", argv[1]);
+      return;
+    }
+    
+    if (on) {
+      traceMask |= TRACE_NAMES[i].category;
+    } else {
+      traceMask &= (uint16_t)~TRACE_NAMES[i].category;
+    }
+  }
+  
+  for (int i = 0; i < NUM_TRACE_NAMES - 1; i++) {
+    Serial.printf("[TRACE] %-8s %s\n", TRACE_NAMES[i].name, (traceMask & TRACE_NAMES[i].category) ? "ON" : "OFF");
+  }
+  if (!debugMode) {
+    Serial.println("[TRACE] Debug output is off (DEBUG ON)");
+  }
+}
+
+// DEBUG ON|OFF
+static void commandDebug(int argc, char* argv[]) {
+  if (argc >= 2) {
+    debugMode = (strcasecmp(argv[1], "ON") == 0);
+  }
+  Serial.printf("[DEBUG] %s\n", debugMode ? "ON" : "OFF");
+}
+
+static void commandHelp(int argc, char* argv[]);
+
+struct SerialCommand {
+  const char* name;
+  void (*handler)(int argc, char* argv[]);
+  const char* usage;
+};
+
+static const SerialCommand SERIAL_COMMANDS[] = {
+  {"IDENTIFY",          commandIdentify,         "IDENTIFY"},
+  {"REBOOT_BOOTLOADER", commandRebootBootloader, "REBOOT_BOOTLOADER"},
+  {"REBOOT_NORMAL",     commandRebootNormal,     "REBOOT_NORMAL"},
+  {"STATS",             commandStats,            "STATS - LED, MIDI, loop and idle statistics"},
+  {"LED_STATS",         commandLEDStats,         "LED_STATS"},
+  {"LED_BENCH",         commandLEDBench,         "LED_BENCH [flips] - page flip rendering, uncached vs cached"},
+  {"MIDI_STATS",        commandMidiStats,        "MIDI_STATS"},
+  {"RECORDER",          commandRecorder,         "RECORDER [DUMP | CLEAR] - event flight recorder, DUMP is binary"},
+  {"IDLE",              commandIdle,             "IDLE [ON|OFF] - sleep between loop passes, CPU busy and wake latency"},
+  {"WATCHDOG",          commandWatchdog,         "WATCHDOG [STALL ms] - loop stalls and the previous run's post-mortem"},
+  {"PAGE",              commandPage,             "PAGE [n] - cached executor status for page n"},
+  {"EFFECT",            commandEffect,           "EFFECT n NONE|BLINK|PULSE|FLASH|FADE [rate 0-15] [phase 0-127] - XKey n, current page"},
+  {"CONFIG",            commandConfig,           "CONFIG [GET name | SET name value | SAVE | DEFAULTS]"},
+  {"TRACE",             commandTrace,            "TRACE [MIDI|STATUS|PAGE|ENCODER|BUTTON|LED|ALL ON|OFF]"},
+  {"DEBUG",             commandDebug,            "DEBUG [ON|OFF]"},
+  {"HELP",              commandHelp,             "HELP"},
+};
+const int NUM_SERIAL_COMMANDS = sizeof(SERIAL_COMMANDS) / sizeof(SERIAL_COMMANDS[0]);
+
+static void commandHelp(int argc, char* argv[]) {
+  for (int i = 0; i < NUM_SERIAL_COMMANDS; i++) {
+    Serial.printf("[HELP] %s\n", SERIAL_COMMANDS[i].usage);
+  }
+}
+
+// Splits the line in place on spaces and runs the matching command
+void processSerialCommand(char* line) {
+  char* argv[SERIAL_COMMAND_MAX_ARGS];
+  int argc = 0;
+  
+  char* p = line;
+  while (*p && argc < SERIAL_COMMAND_MAX_ARGS) {
+    while (*p == ' ' || *p == '\t') *p++ = '\0';
+    if (!*p) break;
+    argv[argc++] = p;
+    while (*p && *p != ' ' && *p != '\t') p++;
+  }
+  
+  if (argc == 0) {
+    return;
+  }
+  
+  for (int i = 0; i < NUM_SERIAL_COMMANDS; i++) {
+    if (strcasecmp(SERIAL_COMMANDS[i].name, argv[0]) == 0) {
+      SERIAL_COMMANDS[i].handler(argc, argv);
+      return;
+    }
+  }
+  
+  Serial.printf("[SERIAL] Unknown command: %s (HELP for a list)\n", argv[0]);
+}
@@ -0,0 +1,251 @@
+#include "watchdog.h"
+#include "midi.h"
+#include "utils.h"
+#include "flightRecorder.h"
+
+// ================================
+// LOOP WATCHDOG
+// ================================
+// loop() marks which subsystem is running, each one is timed against LOOP_STALL_THRESHOLD_US
+// A stall is snapshotted at a fixed address at the top of RAM2 (not cleared on a soft or watchdog reset) and reported
+// after the next boot. A hard hang stops feeding WDOG1, its pre-timeout interrupt takes the
+// snapshot WATCHDOG_WARNING_MS before the reset. The native build only does the stall timing.
+
+static const char* const SUBSYSTEM_NAMES[SUBSYSTEM_COUNT] = {
+  "STARTUP", "IDLE", "MIDI_IN", "ENCODERS", "BUTTONS", "MIDI_OUT", "LED_FRAME", "SERIAL", "EEPROM"
+};
+
+static volatile LoopSubsystem currentSubsystem = SUBSYSTEM_STARTUP;
+static volatile unsigned long subsystemStartUs = 0;
+
+struct WatchdogStats {
+  unsigned long loops;
+  unsigned long lastLoopUs;
+  unsigned long maxLoopUs;
+  unsigned long slowLoops;                          // Loop periods over the stall threshold
+  unsigned long stalls[SUBSYSTEM_COUNT];
+  unsigned long maxStallUs[SUBSYSTEM_COUNT];
+  unsigned long setupMs;
+};
+static WatchdogStats watchdogStats = {};
+
+// Post-mortem snapshot, valid when magic and check match
+#define POSTMORTEM_MAGIC 0x57444F47  // "WDOG"
+
+enum PostMortemReason : uint8_t {
+  POSTMORTEM_STALL = 1,       // Subsystem went over the threshold but returned
+  POSTMORTEM_WATCHDOG = 2     // No loop pass before the watchdog warning, reset follows
+};
+
+struct PostMortem {
+  uint32_t magic;
+  uint8_t reason;
+  uint8_t subsystem;
+  uint8_t page;
+  uint8_t adjustMode;
+  uint32_t durationUs;        // Time spent in the subsystem
+  uint32_t uptimeMs;
+  uint32_t loops;
+  uint32_t stalls;            // Stalls so far in that run
+  int32_t midiRxFree;
+  uint32_t check;
+};
+
+// Written on every stall, survives the reset. The boot ROM uses the bottom of OCRAM (where DMAMEM
+// starts) during a reset, so the record sits just below Teensyduino's CrashReport at 0x2027FF80.
+#ifdef NATIVE_BUILD
+static PostMortem postMortemRecord;
+static PostMortem& postMortem = postMortemRecord;
+#else
+#define POSTMORTEM_ADDRESS 0x2027FF40
+static_assert(sizeof(PostMortem) <= 0x2027FF80 - POSTMORTEM_ADDRESS, "PostMortem overlaps CrashReport");
+static PostMortem& postMortem = *(PostMortem*)POSTMORTEM_ADDRESS;
+#endif
+static PostMortem previousRun;           // Copy taken at boot, before this run overwrites it
+static bool previousRunValid = false;
+#ifndef NATIVE_BUILD
+static uint32_t resetCause = 0;          // SRC_SRSR at boot
+#endif
+
+static uint32_t postMortemCheck(const PostMortem* record) {
+  const uint32_t* words = (const uint32_t*)record;
+  uint32_t check = 0x9E3779B9;
+  for (size_t i = 0; i < offsetof(PostMortem, check) / sizeof(uint32_t); i++) {
+    check = (check ^ words[i]) * 16777619u;
+  }
+  return check;
+}
+
+static unsigned long totalStalls() {
+  unsigned long total = 0;
+  for (int i = 0; i < SUBSYSTEM_COUNT; i++) {
+    total += watchdogStats.stalls[i];
+  }
+  return total;
+}
+
+// Called from loop() and from the watchdog interrupt, plain stores only
+static void writePostMortem(PostMortemReason reason, LoopSubsystem subsystem, unsigned long durationUs) {
+  postMortem.magic = POSTMORTEM_MAGIC;
+  postMortem.reason = reason;
+  postMortem.subsystem = subsystem;
+  postMortem.page = (uint8_t)(currentPage + 1);
+  postMortem.adjustMode = adjustMode;
+  postMortem.durationUs = durationUs;
+  postMortem.uptimeMs = millis();
+  postMortem.loops = watchdogStats.loops;
+  postMortem.stalls = totalStalls();
+  postMortem.midiRxFree = midiRxFree();
+  postMortem.check = postMortemCheck(&postMortem);
+
+#ifndef NATIVE_BUILD
+  // RAM2 is write-back cached, push the record to RAM before anything can reset
+  arm_dcache_flush(&postMortem, sizeof(postMortem));
+#endif
+}
+
+static void printPostMortem(const char* label, const PostMortem* record) {
+  Serial.printf("[WATCHDOG] %s: %s in %s for %lu us | Uptime %lu ms | Loops %lu | Stalls %lu | Page %d | Adjust %s | MIDI ring free %ld\n",
+                label, record->reason == POSTMORTEM_WATCHDOG ? "Watchdog reset" : "Stall",
+                record->subsystem < SUBSYSTEM_COUNT ? SUBSYSTEM_NAMES[record->subsystem] : "?",
+                (unsigned long)record->durationUs, (unsigned long)record->uptimeMs,
+                (unsigned long)record->loops, (unsigned long)record->stalls,
+                record->page, record->adjustMode ? "YES" : "NO", (long)record->midiRxFree);
+}
+
+// ================================
+// HARDWARE WATCHDOG (WDOG1)
+// ================================
+
+#ifndef NATIVE_BUILD
+
+// Pre-timeout interrupt: loop() hasn't come back, record where it is stuck and let the reset happen
+static void watchdogWarningISR() {
+  WDOG1_WICR |= WDOG_WICR_WTIS;
+  writePostMortem(POSTMORTEM_WATCHDOG, currentSubsystem, micros() - subsystemStartUs);
+}
+
+static void beginHardwareWatchdog() {
+  CCM_CCGR3 |= CCM_CCGR3_WDOG1(CCM_CCGR_ON);
+  WDOG1_WMCR = 0;   // Power down counter would reset us 16s after boot
+
+  // WICR is write once, WT and WICT count 500ms steps
+  WDOG1_WICR = WDOG_WICR_WIE | WDOG_WICR_WICT(WATCHDOG_WARNING_MS / 500);
+  attachInterruptVector(IRQ_WDOG1, watchdogWarningISR);
+  NVIC_ENABLE_IRQ(IRQ_WDOG1);
+
+  // SRS/WDA set = no software reset / WDOG_B assertion, WDE can't be cleared until the next reset
+  WDOG1_WCR = WDOG_WCR_WT(WATCHDOG_TIMEOUT_MS / 500 - 1) | WDOG_WCR_SRS | WDOG_WCR_WDA | WDOG_WCR_WDE;
+}
+
+static inline void feedHardwareWatchdog() {
+  WDOG1_WSR = 0x5555;
+  WDOG1_WSR = 0xAAAA;
+}
+
+#endif
+
+// ================================
+// WATCHDOG FUNCTIONS
+// ================================
+
+void initializeWatchdog() {
+  subsystemStartUs = micros();
+
+  if (postMortem.magic == POSTMORTEM_MAGIC && postMortem.check == postMortemCheck(&postMortem)) {
+    previousRun = postMortem;
+    previousRunValid = true;
+  }
+  postMortem.magic = 0;
+
+#ifndef NATIVE_BUILD
+  resetCause = SRC_SRSR;
+  SRC_SRSR = resetCause;   // Write 1 to clear, so the next boot sees only its own cause
+  arm_dcache_flush(&postMortem, sizeof(postMortem));
+#endif
+
+  if (previousRunValid && debugMode) {
+    printPostMortem("Previous run", &previousRun);
+  }
+}
+
+void startWatchdog() {
+  // setup() blocks for the boot animation, report it rather than count it as a loop stall
+  watchdogStats.setupMs = (micros() - subsystemStartUs) / 1000;
+  currentSubsystem = SUBSYSTEM_IDLE;
+  subsystemStartUs = micros();
+
+#ifndef NATIVE_BUILD
+  beginHardwareWatchdog();
+#endif
+}
+
+void serviceWatchdog() {
+  static unsigned long lastLoopUs = 0;
+  unsigned long now = micros();
+
+#ifndef NATIVE_BUILD
+  feedHardwareWatchdog();
+#endif
+
+  if (watchdogStats.loops > 0) {
+    unsigned long period = now - lastLoopUs;
+    watchdogStats.lastLoopUs = period;
+    if (period > watchdogStats.maxLoopUs) {
+      watchdogStats.maxLoopUs = period;
+    }
+    if (period > LOOP_STALL_THRESHOLD_US) {
+      watchdogStats.slowLoops++;
+    }
+  }
+  lastLoopUs = now;
+  watchdogStats.loops++;
+}
+
+LoopSubsystem markSubsystem(LoopSubsystem subsystem) {
+  unsigned long now = micros();
+  LoopSubsystem previous = currentSubsystem;
+  unsigned long elapsed = now - subsystemStartUs;
+
+  if (elapsed > LOOP_STALL_THRESHOLD_US) {
+    watchdogStats.stalls[previous]++;
+    if (elapsed > watchdogStats.maxStallUs[previous]) {
+      watchdogStats.maxStallUs[previous] = elapsed;
+    }
+    writePostMortem(POSTMORTEM_STALL, previous, elapsed);
+    recordFlightEvent16(FLIGHT_STALL, previous, elapsed / 1000);
+    debugPrintf("[WATCHDOG] Stall in %s: %lu us", SUBSYSTEM_NAMES[previous], elapsed);
+    now = micros();   // Don't charge the print to the next subsystem
+  }
+
+  currentSubsystem = subsystem;
+  subsystemStartUs = now;
+  return previous;
+}
+
+void printWatchdogStats() {
+  Serial.printf("[WATCHDOG] Loops: %lu | Loop period last %lu us, max %lu us | Over %lu us: %lu | Setup: %lu ms\n",
+                watchdogStats.loops, watchdogStats.lastLoopUs, watchdogStats.maxLoopUs,
+                LOOP_STALL_THRESHOLD_US, watchdogStats.slowLoops, watchdogStats.setupMs);
+
+  for (int i = 0; i < SUBSYSTEM_COUNT; i++) {
+    if (watchdogStats.stalls[i] > 0) {
+      Serial.printf("[WATCHDOG] Stalls in %-9s %lu (max %lu us)\n",
+                    SUBSYSTEM_NAMES[i], watchdogStats.stalls[i], watchdogStats.maxStallUs[i]);
+    }
+  }
+  if (postMortem.magic == POSTMORTEM_MAGIC) {
+    printPostMortem("Last stall", &postMortem);
+  }
+
+#ifndef NATIVE_BUILD
+  Serial.printf("[WATCHDOG] Hardware timeout %lu ms | Reset cause 0x%08lX%s\n",
+                WATCHDOG_TIMEOUT_MS, (unsigned long)resetCause,
+                (resetCause & (1 << 4)) ? " (watchdog)" : "");   // SRSR bit 4 = WDOG_RST_B
+#endif
+  if (previousRunValid) {
+    printPostMortem("Previous run", &previousRun);
+  } else {
+    Serial.println("[WATCHDOG] Previous run: no stall recorded");
+  }
+}
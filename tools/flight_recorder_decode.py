@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""
+EvoCmdWing flight recorder decoder
+
+Fetches the firmware's event ring (serial command RECORDER DUMP) and prints it as a timeline
+The binary layout is described in src/flightRecorder.cpp, event types in include/flightRecorder.h
+
+Usage:
+    python tools/flight_recorder_decode.py --port /dev/ttyACM0           # request a dump and decode it
+    python tools/flight_recorder_decode.py --port COM5 --save dump.bin   # keep the raw capture too
+    python tools/flight_recorder_decode.py capture.bin                   # decode a saved capture
+    .pio/build/native/program | tee capture.bin                          # native build, type RECORDER DUMP
+
+Options:
+    --last N     only the newest N events
+    --type T     only events of these types (ENCODER, BUTTON, MIDI_IN, MIDI_OUT, PAGE, LED_FRAME, STALL, BOOT)
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+MAGIC = b"EVFR"
+HEADER = struct.Struct("<4sBBHIII")
+RECORD = struct.Struct("<IB3s")
+
+EVENT_NAMES = {
+    1: "BOOT",
+    2: "ENCODER",
+    3: "BUTTON",
+    4: "MIDI_IN",
+    5: "MIDI_OUT",
+    6: "PAGE",
+    7: "LED_FRAME",
+    8: "STALL",
+}
+
+# LoopSubsystem in include/watchdog.h
+SUBSYSTEM_NAMES = ["STARTUP", "IDLE", "MIDI_IN", "ENCODERS", "BUTTONS", "MIDI_OUT", "LED_FRAME", "SERIAL", "EEPROM"]
+
+
+def describe_midi(status, data1, data2):
+    kind = status & 0xF0
+    channel = (status & 0x0F) + 1
+    if kind == 0xB0:
+        return f"CC     ch{channel:<2} cc {data1:3d} = {data2:3d}"
+    if kind == 0x90:
+        return f"Note   ch{channel:<2} note {data1:3d} vel {data2:3d}"
+    if kind == 0x80:
+        return f"NoteOff ch{channel:<2} note {data1:3d}"
+    return f"0x{status:02X} {data1:3d} {data2:3d}"
+
+
+def describe(event_type, data):
+    a, b, c = data
+    value16 = b | (c << 8)
+    if event_type == 1:
+        return "Firmware started"
+    if event_type == 2:
+        direction = b - 256 if b > 127 else b
+        return f"Encoder {a + 1:2d} {direction:+d}"
+    if event_type == 3:
+        return f"Button {a + 1:2d} {'pressed' if b else 'released'}"
+    if event_type in (4, 5):
+        return describe_midi(a, b, c)
+    if event_type == 6:
+        return f"Page {b} -> {a}"
+    if event_type == 7:
+        return f"Frame shown {value16} us after first change{' (forced, incomplete RGB)' if a else ''}"
+    if event_type == 8:
+        name = SUBSYSTEM_NAMES[a] if a < len(SUBSYSTEM_NAMES) else f"#{a}"
+        return f"Loop stalled in {name} for {value16} ms"
+    return f"{a} {b} {c}"
+
+
+def parse_dump(data):
+    """Returns (header dict, [(time_us, type, data)]) from a capture that contains a dump"""
+    start = data.find(MAGIC)
+    if start < 0:
+        raise ValueError("no flight recorder dump found (missing EVFR header)")
+    if len(data) < start + HEADER.size:
+        raise ValueError("capture ends inside the dump header")
+
+    magic, version, record_size, capacity, records, overwritten, now_us = HEADER.unpack_from(data, start)
+    if version != 1 or record_size != RECORD.size:
+        raise ValueError(f"unsupported dump version {version} / record size {record_size}")
+
+    offset = start + HEADER.size
+    available = (len(data) - offset) // RECORD.size
+    if available < records:
+        print(f"Warning: capture has {available} of {records} records", file=sys.stderr)
+        records = available
+
+    events = []
+    for i in range(records):
+        time_us, event_type, payload = RECORD.unpack_from(data, offset + i * RECORD.size)
+        events.append((time_us, event_type, payload))
+
+    header = {"capacity": capacity, "records": records, "overwritten": overwritten, "now_us": now_us}
+    return header, events
+
+
+def unwrap_times(events):
+    """micros() wraps every ~71 minutes, keep the timeline increasing"""
+    result = []
+    offset = 0
+    previous = None
+    for time_us, event_type, payload in events:
+        if previous is not None and time_us < previous and previous - time_us > 0x80000000:
+            offset += 1 << 32
+        previous = time_us
+        result.append((time_us + offset, event_type, payload))
+    return result
+
+
+def print_timeline(header, events, last=None, types=None):
+    events = unwrap_times(events)
+    if types:
+        events = [e for e in events if EVENT_NAMES.get(e[1], "?") in types]
+    if last:
+        events = events[-last:]
+
+    print(f"{header['records']} events (ring of {header['capacity']}, {header['overwritten']} older overwritten)")
+    if not events:
+        return
+
+    first = events[0][0]
+    previous = first
+    counts = {}
+    for time_us, event_type, payload in events:
+        name = EVENT_NAMES.get(event_type, f"TYPE_{event_type}")
+        counts[name] = counts.get(name, 0) + 1
+        print(f"{(time_us - first) / 1e6:12.6f} s  +{(time_us - previous) / 1000:9.3f} ms  {name:<9}  {describe(event_type, payload)}")
+        previous = time_us
+
+    span = (events[-1][0] - first) / 1e6
+    print(f"\n{len(events)} events over {span:.3f} s: " + ", ".join(f"{k} {v}" for k, v in sorted(counts.items())))
+
+
+def capture_from_port(port, baud, timeout):
+    import serial  # pyserial, as used by teensy_auto_upload.py
+
+    with serial.Serial(port, baud, timeout=0.2) as connection:
+        connection.reset_input_buffer()
+        connection.write(b"RECORDER DUMP\n")
+
+        data = bytearray()
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            data += connection.read(4096)
+            start = data.find(MAGIC)
+            if start >= 0 and len(data) >= start + HEADER.size:
+                records = HEADER.unpack_from(data, start)[4]
+                if len(data) >= start + HEADER.size + records * RECORD.size:
+                    return bytes(data)
+        return bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode an EvoCmdWing flight recorder dump")
+    parser.add_argument("capture", nargs="?", help="saved capture containing a RECORDER DUMP ('-' for stdin)")
+    parser.add_argument("--port", help="serial port to request the dump from")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds to wait for the dump")
+    parser.add_argument("--save", help="write the raw capture to this file")
+    parser.add_argument("--last", type=int, help="only the newest N events")
+    parser.add_argument("--type", nargs="+", type=str.upper, help="only these event types")
+    args = parser.parse_args()
+
+    if args.port:
+        data = capture_from_port(args.port, args.baud, args.timeout)
+    elif args.capture == "-":
+        data = sys.stdin.buffer.read()
+    elif args.capture:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+    else:
+        parser.error("give a capture file or --port")
+
+    if args.save:
+        with open(args.save, "wb") as f:
+            f.write(data)
+
+    try:
+        header, events = parse_dump(data)
+    except ValueError as error:
+        print(f"Error: {error}", file=sys.stderr)
+        return 1
+
+    print_timeline(header, events, args.last, args.type)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
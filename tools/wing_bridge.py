@@ -0,0 +1,344 @@
+#!/usr/bin/env python3
+"""
+EvoCmdWing native bridge client
+
+Talks raw MIDI to the native firmware build ([env:native]) over its UNIX domain socket
+Encoder/button input is injected on MIDI channel 16 (see lib/NativeShim/NativeBridge.h)
+
+Usage:
+    python tools/wing_bridge.py monitor
+    python tools/wing_bridge.py encoder 5 +3          # XKey encoder 1 (index 5), three detents right
+    python tools/wing_bridge.py button 33              # press and release the button on GPIO 33
+    python tools/wing_bridge.py send 2 1 127           # CC on channel 2: XKey 1 populated and on
+    python tools/wing_bridge.py latency --count 200    # encoder detent -> CC round trip
+    python tools/wing_bridge.py throughput --count 2000
+    python tools/wing_bridge.py digest                 # current page's digests (4 groups of XKeys)
+    python tools/wing_bridge.py ping --count 100       # link ping round trip and wing ring depth
+    python tools/wing_bridge.py --cable 1 ping         # same on the feedback cable (USB MIDI port 2)
+
+Socket path defaults to /tmp/evocmdwing.sock, or EVOCMDWING_SOCKET / --socket
+"""
+
+import argparse
+import os
+import socket
+import statistics
+import sys
+import time
+
+DEFAULT_SOCKET = os.environ.get("EVOCMDWING_SOCKET", "/tmp/evocmdwing.sock")
+
+INJECT_CHANNEL = 16
+CABLE_SELECT = 0xF5
+CABLE_CONTROL = 0
+CABLE_FEEDBACK = 1
+LINK_CHANNEL = 4
+LINK_CC_CREDITS = 1
+LINK_CC_GRANT = 2
+LINK_CC_DIGEST_REQUEST = 2
+LINK_CC_DIGEST_NUMBER = 3
+LINK_CC_DIGEST = 4          # Low 7 bits
+LINK_CC_DIGEST_HIGH = 10    # High 7 bits
+PAGE_DIGEST_GROUPS = 4
+LINK_CC_PING = 3
+LINK_CC_PONG_DEPTH = 8
+LINK_CC_PONG = 9
+
+
+class WingBridge:
+    """Raw MIDI connection to the native firmware, with a small parser for what it sends back"""
+
+    def __init__(self, path=DEFAULT_SOCKET, timeout=2.0):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self.sock.settimeout(timeout)
+        self.buffer = bytearray()
+
+    def close(self):
+        self.sock.close()
+
+    # ---- Sending ----
+
+    def send_raw(self, data):
+        self.sock.sendall(bytes(data))
+
+    def select_cable(self, cable):
+        """USB MIDI cable the following messages arrive on (0 = control, 1 = feedback)"""
+        self.send_raw([CABLE_SELECT, cable & 0x03])
+
+    def control_change(self, channel, cc, value):
+        self.send_raw([0xB0 | ((channel - 1) & 0x0F), cc & 0x7F, value & 0x7F])
+
+    def note_on(self, channel, note, velocity):
+        self.send_raw([0x90 | ((channel - 1) & 0x0F), note & 0x7F, velocity & 0x7F])
+
+    def encoder(self, index, detents):
+        """Turn simulated encoder `index` by `detents` (negative = left)"""
+        while detents:
+            step = max(-63, min(63, detents))
+            self.control_change(INJECT_CHANNEL, index, 64 + step)
+            detents -= step
+
+    def button(self, pin, pressed):
+        self.note_on(INJECT_CHANNEL, pin, 127 if pressed else 0)
+
+    # ---- Receiving ----
+
+    def receive(self, timeout=None):
+        """Next (type, channel, data1, data2) from the firmware, None on timeout"""
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while len(self.buffer) < 3:
+            if deadline is not None:
+                remaining = deadline - time.monotonic()
+                if remaining <= 0:
+                    return None
+                self.sock.settimeout(remaining)
+            try:
+                chunk = self.sock.recv(4096)
+            except socket.timeout:
+                return None
+            if not chunk:
+                raise ConnectionError("firmware closed the bridge")
+            self.buffer.extend(chunk)
+            # Firmware always sends full status + 2 data byte messages
+            while self.buffer and not (self.buffer[0] & 0x80):
+                del self.buffer[0]
+        status, d1, d2 = self.buffer[0], self.buffer[1], self.buffer[2]
+        del self.buffer[:3]
+        return status & 0xF0, (status & 0x0F) + 1, d1, d2
+
+    def wait_for(self, predicate, timeout=1.0):
+        deadline = time.monotonic() + timeout
+        while True:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                return None
+            msg = self.receive(remaining)
+            if msg is None:
+                return None
+            if predicate(msg):
+                return msg
+
+    def request_credits(self, number=1, timeout=1.0):
+        """Ask for receive credits, returns (credits, grant) once the wing answers `number`"""
+        credits = None
+        self.control_change(LINK_CHANNEL, LINK_CC_CREDITS, number)
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            msg = self.receive(deadline - time.monotonic())
+            if msg is None:
+                break
+            kind, ch, d1, d2 = msg
+            if kind == 0xB0 and ch == LINK_CHANNEL and d1 == LINK_CC_CREDITS:
+                credits = d2
+            elif kind == 0xB0 and ch == LINK_CHANNEL and d1 == LINK_CC_GRANT and credits is not None:
+                # Keepalives (grant 0) don't answer the request
+                if d2 == number:
+                    return credits, d2
+                credits = None
+        return None
+
+    def request_digests(self, number=1, timeout=1.0):
+        """Ask for the current page's 14 bit digests, returns the list once the wing answers with `number`"""
+        low, high = [None] * PAGE_DIGEST_GROUPS, [None] * PAGE_DIGEST_GROUPS
+        self.control_change(LINK_CHANNEL, LINK_CC_DIGEST_REQUEST, number)
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            msg = self.receive(deadline - time.monotonic())
+            if msg is None:
+                break
+            kind, ch, d1, d2 = msg
+            if kind != 0xB0 or ch != LINK_CHANNEL:
+                continue
+            if LINK_CC_DIGEST <= d1 < LINK_CC_DIGEST + PAGE_DIGEST_GROUPS:
+                low[d1 - LINK_CC_DIGEST] = d2
+            elif LINK_CC_DIGEST_HIGH <= d1 < LINK_CC_DIGEST_HIGH + PAGE_DIGEST_GROUPS:
+                high[d1 - LINK_CC_DIGEST_HIGH] = d2
+            elif d1 == LINK_CC_DIGEST_NUMBER and d2 == number:
+                return [None if l is None or h is None else h << 7 | l for l, h in zip(low, high)]
+        return None
+
+    def ping(self, ping_id, timeout=1.0):
+        """Ping the wing, returns the receive ring depth it reports once the answer for `ping_id` arrives"""
+        depth = None
+        self.control_change(LINK_CHANNEL, LINK_CC_PING, ping_id)
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            msg = self.receive(deadline - time.monotonic())
+            if msg is None:
+                break
+            kind, ch, d1, d2 = msg
+            if kind == 0xB0 and ch == LINK_CHANNEL and d1 == LINK_CC_PONG_DEPTH:
+                depth = d2
+            elif kind == 0xB0 and ch == LINK_CHANNEL and d1 == LINK_CC_PONG and d2 == ping_id:
+                return depth
+        return None
+
+
+def describe(msg):
+    kind, ch, d1, d2 = msg
+    names = {0x80: "NoteOff", 0x90: "NoteOn", 0xB0: "CC"}
+    return "%-7s ch%-2d %3d %3d" % (names.get(kind, hex(kind)), ch, d1, d2)
+
+
+def report(label, samples_us):
+    if not samples_us:
+        print("%s: no samples" % label)
+        return
+    samples_us = sorted(samples_us)
+    p99 = samples_us[min(len(samples_us) - 1, int(len(samples_us) * 0.99))]
+    print("%s: n=%d min=%.0fus median=%.0fus p99=%.0fus max=%.0fus" % (
+        label, len(samples_us), samples_us[0], statistics.median(samples_us), p99, samples_us[-1]))
+
+
+def cmd_monitor(bridge, args):
+    start = time.monotonic()
+    while True:
+        msg = bridge.receive()
+        if msg:
+            print("%10.3f  %s" % (time.monotonic() - start, describe(msg)))
+
+
+def cmd_encoder(bridge, args):
+    bridge.encoder(args.index, args.detents)
+    msg = bridge.receive(0.5)
+    print(describe(msg) if msg else "no output (adjust mode, or throttled)")
+
+
+def cmd_button(bridge, args):
+    bridge.button(args.pin, True)
+    time.sleep(args.hold)
+    bridge.button(args.pin, False)
+    while True:
+        msg = bridge.receive(0.2)
+        if not msg:
+            break
+        print(describe(msg))
+
+
+def cmd_send(bridge, args):
+    bridge.control_change(args.channel, args.cc, args.value)
+
+
+def cmd_latency(bridge, args):
+    """Injected encoder detent -> CC out, through handleEncoders()/sendMidiEncoder()"""
+    samples = []
+    cc = args.index + 1
+    for i in range(args.count):
+        direction = 1 if (i // 20) % 2 == 0 else -1
+        start = time.perf_counter()
+        bridge.encoder(args.index, direction)
+        msg = bridge.wait_for(lambda m: m[0] == 0xB0 and m[1] == 1 and m[2] == cc, 0.5)
+        if msg:
+            samples.append((time.perf_counter() - start) * 1e6)
+        # Firmware ignores moves closer than 5ms apart (sendMidiEncoder)
+        time.sleep(0.006)
+    report("Encoder detent -> CC", samples)
+
+
+def cmd_throughput(bridge, args):
+    """Status CCs into handleIncomingMIDI(), paced by the wing's receive credits"""
+    sent = 0
+    start = time.perf_counter()
+    number = 1
+    grant = bridge.request_credits(number)
+    while sent < args.count and grant:
+        credits, _ = grant
+        burst = max(0, min(credits - 1, args.count - sent))
+        data = bytearray()
+        for i in range(burst):
+            xkey = (sent + i) % 16 + 1
+            data += bytes([0xB1, xkey, 127 if (sent + i) % 2 else 65])
+        bridge.send_raw(data)
+        sent += burst
+        number = number % 127 + 1
+        grant = bridge.request_credits(number)
+    elapsed = time.perf_counter() - start
+    print("Sent %d status messages in %.3fs: %.0f msg/s" % (sent, elapsed, sent / elapsed if elapsed else 0))
+
+
+def cmd_ping(bridge, args):
+    """Link ping -> answer, the same pair the plugin uses for its round trip stats"""
+    samples = []
+    depths = []
+    for i in range(args.count):
+        start = time.perf_counter()
+        depth = bridge.ping(i % 127 + 1)
+        if depth is not None:
+            samples.append((time.perf_counter() - start) * 1e6)
+            depths.append(depth)
+        time.sleep(args.interval)
+    report("Ping round trip", samples)
+    if depths:
+        print("Wing ring depth: max %d" % max(depths))
+
+
+def cmd_digest(bridge, args):
+    digests = bridge.request_digests(args.number)
+    print("Page digests: %s" % " ".join(str(d) for d in digests) if digests else "no answer")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="EvoCmdWing native bridge client")
+    parser.add_argument("--socket", default=DEFAULT_SOCKET)
+    parser.add_argument("--cable", type=int, default=CABLE_CONTROL, help="USB MIDI cable to send on (0-3)")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    sub.add_parser("monitor", help="print everything the firmware sends")
+
+    p = sub.add_parser("encoder", help="turn a simulated encoder")
+    p.add_argument("index", type=int, help="encoder index 0-12 (5-12 = XKey encoders)")
+    p.add_argument("detents", type=int)
+
+    p = sub.add_parser("button", help="press and release a button")
+    p.add_argument("pin", type=int, help="GPIO pin (28-41)")
+    p.add_argument("--hold", type=float, default=0.1)
+
+    p = sub.add_parser("send", help="send one CC to the firmware")
+    p.add_argument("channel", type=int)
+    p.add_argument("cc", type=int)
+    p.add_argument("value", type=int)
+
+    p = sub.add_parser("latency", help="encoder input to MIDI output latency")
+    p.add_argument("--index", type=int, default=5)
+    p.add_argument("--count", type=int, default=200)
+
+    p = sub.add_parser("throughput", help="credit paced status message throughput")
+    p.add_argument("--count", type=int, default=2000)
+
+    p = sub.add_parser("ping", help="link ping round trip")
+    p.add_argument("--count", type=int, default=100)
+    p.add_argument("--interval", type=float, default=0.01)
+
+    p = sub.add_parser("digest", help="request the current page's digests")
+    p.add_argument("--number", type=int, default=1, help="request number 1-127")
+
+    args = parser.parse_args()
+    try:
+        bridge = WingBridge(args.socket)
+    except OSError as e:
+        print("Could not connect to %s: %s (is the native build running?)" % (args.socket, e))
+        return 1
+
+    try:
+        if args.cable != CABLE_CONTROL:
+            bridge.select_cable(args.cable)
+        {
+            "monitor": cmd_monitor,
+            "encoder": cmd_encoder,
+            "button": cmd_button,
+            "send": cmd_send,
+            "latency": cmd_latency,
+            "throughput": cmd_throughput,
+            "ping": cmd_ping,
+            "digest": cmd_digest,
+        }[args.command](bridge, args)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        bridge.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,776 @@
+#!/usr/bin/env python3
+"""
+EvoCmdWing synthetic show load generator
+
+Drives the wing with show-like and adversarial MIDI on channels 1-3 (what the plugin sends) and reports
+how it held up: achieved message rate, LED frame rate, input latency under load, dropped messages and
+misapplied updates. Every message sent is also applied to a model of the wing's page cache, the wing's
+page digests are compared with the model's at the end.
+
+Usage:
+    python tools/wing_loadgen.py --launch .pio/build/native/program        # every scenario, fresh native build
+    python tools/wing_loadgen.py chase colors --duration 10                  # native build already running
+    python tools/wing_loadgen.py mixed --flood                               # ignore the wing's receive credits
+    python tools/wing_loadgen.py mixed --midi-port EvoCmdWing --serial /dev/ttyACM0   # Teensy (mido, pyserial)
+
+Scenarios:
+    chase      executors chasing on/off at 30 Hz (status CCs)
+    colors     appearance colour sweep over every XKey at 30 Hz (RGB CCs)
+    pages      page scrolling at 10 Hz with fader sync, and prefetched pages in between (channel 3)
+    faders     fader feedback storm on the XKey encoders at 200 Hz (channel 1 CC 6-13)
+    malformed  out-of-range values, unknown CCs and message types, broken byte streams (native only)
+    mixed      all of the above at once
+
+Plugin traffic goes on the feedback cable (USB MIDI port 2) unless --cable says otherwise, on a real wing
+--midi-port picks the port.
+Serial (STATS before and after) comes from the launched native build's stdin/stdout or --serial,
+without it frame rate and dropped messages are not reported
+"""
+
+import argparse
+import colorsys
+import os
+import queue
+import random
+import re
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+from wing_bridge import (DEFAULT_SOCKET, LINK_CHANNEL, LINK_CC_CREDITS, LINK_CC_GRANT,
+                         LINK_CC_DIGEST_REQUEST, LINK_CC_DIGEST_NUMBER, LINK_CC_DIGEST, LINK_CC_DIGEST_HIGH,
+                         PAGE_DIGEST_GROUPS, LINK_CC_PING, LINK_CC_PONG_DEPTH, LINK_CC_PONG,
+                         CABLE_FEEDBACK, WingBridge, report)
+
+SCENARIOS = ["chase", "colors", "pages", "faders", "malformed"]
+FADER_CC = 6          # Channel 1 CC of the first XKey encoder
+EFFECT_CC_PHASE = 3   # Channel 3 LED effect phase, effects for XKey n on CC 32 + n - 1
+EFFECT_CC_FIRST = 32
+PROBE_ENCODER = 0     # Relative attribute encoder, answers on channel 1 CC 1
+PROBE_INTERVAL = 0.1
+
+
+class Raw:
+    """Bytes sent as they are, `messages` is what the wing's parser makes of them (None = not a CC)"""
+
+    def __init__(self, data, messages):
+        self.data = bytes(data)
+        self.messages = messages
+
+
+def cc_bytes(channel, cc, value):
+    return bytes([0xB0 | (channel - 1), cc & 0x7F, value & 0x7F])
+
+
+# ================================
+# WING MODEL
+# ================================
+
+class WingModel:
+    """The firmware's page cache (pageData), following handlePageMIDI()/handleStatusMIDI()"""
+
+    def __init__(self, xkeys, encoders):
+        self.xkeys = xkeys
+        self.encoders = encoders
+        self.group_keys = (xkeys + PAGE_DIGEST_GROUPS - 1) // PAGE_DIGEST_GROUPS
+        self.pages = {}
+        self.current = 1
+        self.write = None
+        self.touched = set()
+
+    def keys(self, page):
+        if page not in self.pages:
+            # [status, red, green, blue, fader or None]
+            self.pages[page] = [[0, 0, 0, 0, None] for _ in range(self.xkeys)]
+        return self.pages[page]
+
+    def apply(self, channel, cc, value):
+        page = self.write or self.current
+        if channel == 1:
+            key = cc - FADER_CC
+            if 0 <= key < self.encoders:
+                self.keys(page)[key][4] = value
+                self.touched.add(page)
+        elif channel == 2:
+            if 1 <= cc <= self.xkeys:
+                self.keys(page)[cc - 1][0] = value if value in (65, 127) else 0
+                self.touched.add(page)
+            elif self.xkeys < cc <= self.xkeys * 4:
+                key, component = divmod(cc - self.xkeys - 1, 3)
+                self.keys(page)[key][1 + component] = value
+                self.touched.add(page)
+        elif channel == 3:
+            if cc == 1:
+                self.current = min(max(value, 1), 127)
+                self.write = None
+            elif cc == 2:
+                self.write = None if value in (0, self.current) else value
+
+    def digest(self, page, group):
+        """pageGroupDigest()"""
+        h = 1
+        first = group * self.group_keys
+        for i, (status, r, g, b, fader) in enumerate(self.keys(page)[first:first + self.group_keys], first):
+            h = (h * 31 + status) % 16381
+            if status:
+                for v in (r, g, b):
+                    h = (h * 31 + v) % 16381
+            if i < self.encoders:
+                h = (h * 31 + (128 if fader is None else fader)) % 16381
+        return h
+
+
+# ================================
+# SCENARIOS
+# ================================
+# tick() returns the messages for one step: (channel, cc, value) tuples or Raw
+
+class Chase:
+    interval = 1 / 30
+
+    def __init__(self, args, rng):
+        self.xkeys = args.xkeys
+        self.step = 0
+
+    def tick(self, model):
+        # Every 4th executor on, moving one key per step, only the keys that change are sent
+        self.step += 1
+        out = []
+        for key in range(self.xkeys):
+            was = (key - self.step + 1) % 4 == 0
+            now = (key - self.step) % 4 == 0
+            if was != now:
+                out.append((2, key + 1, 127 if now else 65))
+        return out
+
+
+class Colors:
+    interval = 1 / 30
+
+    def __init__(self, args, rng):
+        self.xkeys = args.xkeys
+        self.hue = 0.0
+
+    def tick(self, model):
+        self.hue = (self.hue + 0.01) % 1.0
+        out = []
+        for key in range(self.xkeys):
+            rgb = colorsys.hsv_to_rgb((self.hue + key / self.xkeys) % 1.0, 1.0, 1.0)
+            for c, v in enumerate(rgb):
+                out.append((2, self.xkeys + 1 + key * 3 + c, int(v * 127)))
+        return out
+
+
+class Pages:
+    interval = 1 / 10
+
+    def __init__(self, args, rng):
+        self.args = args
+        self.rng = rng
+        self.step = 0
+
+    def tick(self, model):
+        # Next page with the plugin's fader sync and a couple of status/RGB changes
+        args, rng = self.args, self.rng
+        self.step += 1
+        page = self.step % args.pages + 1
+        out = [(3, 1, page)]
+        out += [(1, FADER_CC + e, rng.randrange(128)) for e in range(args.encoders)]
+        out += self.key_update(rng.randrange(args.xkeys))
+
+        # Every third step a prefetched page in the background, like the plugin's prefetch frames
+        if self.step % 3 == 0:
+            other = rng.randrange(args.pages) + 1
+            out.append((3, 2, other))
+            for key in rng.sample(range(args.xkeys), 3):
+                out += self.key_update(key)
+            out += [(1, FADER_CC + e, rng.randrange(128)) for e in range(min(2, args.encoders))]
+            out.append((3, 2, 0))
+        return out
+
+    def key_update(self, key):
+        rng, n = self.rng, self.args.xkeys
+        out = [(2, key + 1, rng.choice((65, 127)))]
+        out += [(2, n + 1 + key * 3 + c, rng.randrange(128)) for c in range(3)]
+        return out
+
+
+class Faders:
+    interval = 1 / 200
+
+    def __init__(self, args, rng):
+        self.rng = rng
+        self.values = [64] * args.encoders
+
+    def tick(self, model):
+        out = []
+        for e, v in enumerate(self.values):
+            v = min(127, max(0, v + self.rng.randint(-4, 4)))
+            self.values[e] = v
+            out.append((1, FADER_CC + e, v))
+        return out
+
+
+class Malformed:
+    interval = 1 / 20
+
+    def __init__(self, args, rng, raw_ok=True):
+        self.args = args
+        self.rng = rng
+        self.cases = [self.bad_status, self.unknown_cc, self.page_edges, self.other_types, self.running_status]
+        # Broken byte streams only go through the native socket, a MIDI port carries complete messages
+        if raw_ok:
+            self.cases += [self.sysex, self.realtime_inside, self.truncated, self.stray_data]
+        self.step = 0
+
+    def tick(self, model):
+        case = self.cases[self.step % len(self.cases)]
+        self.step += 1
+        return case(model)
+
+    def key(self):
+        return self.rng.randrange(self.args.xkeys) + 1
+
+    def bad_status(self, model):
+        # Anything but 0/65/127 reads as not populated
+        return [(2, self.key(), self.rng.choice((1, 33, 64, 66, 100, 126)))]
+
+    def unknown_cc(self, model):
+        n, e, rng = self.args.xkeys, self.args.encoders, self.rng
+        return [
+            (1, rng.choice([0] + list(range(FADER_CC + e, 128))), rng.randrange(128)),
+            (2, rng.choice([0] + list(range(n * 4 + 1, 128))), rng.randrange(128)),
+            (3, rng.choice([c for c in range(EFFECT_CC_PHASE + 1, 128)
+                            if not EFFECT_CC_FIRST <= c < EFFECT_CC_FIRST + n]), rng.randrange(128)),
+            (4, rng.randrange(10, 128), rng.randrange(128)),
+        ]
+
+    def page_edges(self, model):
+        # Page 0 is page 1, writing the current page is the same as no write page
+        return [(3, 1, 0), (3, 2, model.current), (2, self.key(), 65), (3, 2, 0)]
+
+    def other_types(self, model):
+        key = self.key()
+        data = bytes([0x91, key, 100, 0x82, 7, 0, 0xC2, 5, 0xE0, 0, 64, 0xD1, 90, 0xA1, key, 20])
+        return [Raw(data, [None] * 6)]
+
+    def running_status(self, model):
+        a, b = self.key(), self.key()
+        return [Raw([0xB1, a, 127, b, 65], [(2, a, 127), (2, b, 65)])]
+
+    def sysex(self, model):
+        # Data bytes that would be a status CC, inside sysex and right after it (sysex cancels running status)
+        key = self.key()
+        return [Raw([0xB1, key, 65, 0xF0, key, 127, 0x11, 0xF7, key, 127], [(2, key, 65)])]
+
+    def realtime_inside(self, model):
+        key = self.key()
+        return [Raw([0xB1, 0xF8, key, 0xFE, 127], [(2, key, 127)])]
+
+    def truncated(self, model):
+        # Status and one data byte, then a new message: the half message is lost
+        a, b = self.key(), self.key()
+        return [Raw([0xB1, a, 0xB1, b, 65], [(2, b, 65)])]
+
+    def stray_data(self, model):
+        # System common cancels running status, its data and what follows are ignored
+        key = self.key()
+        return [Raw([0xF2, 5, 0x7F, key, 127], [])]
+
+
+SCENARIO_CLASSES = {"chase": Chase, "colors": Colors, "pages": Pages, "faders": Faders, "malformed": Malformed}
+
+
+# ================================
+# CONNECTIONS
+# ================================
+
+class BridgeLink:
+    """Native build socket, raw bytes and channel 16 input injection"""
+
+    raw_ok = True
+    can_inject = True
+
+    def __init__(self, path, cable):
+        self.bridge = WingBridge(path)
+        self.bridge.select_cable(cable)
+
+    def send_bytes(self, data):
+        self.bridge.sock.settimeout(5.0)  # receive() leaves the last poll's timeout behind
+        self.bridge.send_raw(data)
+
+    def receive(self, timeout):
+        return self.bridge.receive(max(timeout, 0.0001))
+
+    def encoder(self, index, detents):
+        self.bridge.encoder(index, detents)
+
+    def close(self):
+        self.bridge.close()
+
+
+class MidoLink:
+    """USB MIDI port of a real wing, complete messages only"""
+
+    raw_ok = False
+    can_inject = False
+
+    def __init__(self, name):
+        import mido
+        self.mido = mido
+        self.outport = mido.open_output(name)
+        self.inport = mido.open_input(name)
+        self.parser = mido.Parser()
+
+    def send_bytes(self, data):
+        self.parser.feed(data)
+        for msg in self.parser:
+            self.outport.send(msg)
+
+    def receive(self, timeout):
+        deadline = time.monotonic() + timeout
+        while True:
+            msg = self.inport.poll()
+            if msg is not None:
+                if msg.type == "control_change":
+                    return 0xB0, msg.channel + 1, msg.control, msg.value
+                continue
+            if time.monotonic() >= deadline:
+                return None
+            time.sleep(0.0002)
+
+    def close(self):
+        self.inport.close()
+        self.outport.close()
+
+
+class Console:
+    """Serial command line: the launched native build's stdin/stdout, or a serial port"""
+
+    STATS_PATTERNS = {
+        "frames": r"\[LED STATS\] Frames: (\d+) \| Forced: (\d+)",
+        "midi": r"\[MIDI STATS\] Received: (\d+) \| Processed: (\d+) \| Ring: \d+/\d+ \(high water (\d+)\) \| Ring full polls: (\d+)",
+        "bridge": r"\[BRIDGE\] Received: (\d+) messages \(\d+ bytes\) \| Dropped \(queue full\): (\d+)",
+        "busy": r"\[IDLE\] Sleep: \w+ \| CPU busy: ([\d.]+)%",
+    }
+
+    def __init__(self, write, readline):
+        self.write = write
+        self.lines = queue.Queue()
+        threading.Thread(target=self._reader, args=(readline,), daemon=True).start()
+
+    def _reader(self, readline):
+        while True:
+            line = readline()
+            if not line:
+                break
+            self.lines.put(line.rstrip())
+
+    def command(self, text, quiet=0.3, timeout=3.0):
+        """Send a command, returns the lines that follow until the output goes quiet"""
+        while not self.lines.empty():
+            self.lines.get_nowait()
+        self.write(text + "\n")
+        out = []
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            try:
+                out.append(self.lines.get(timeout=quiet))
+            except queue.Empty:
+                if out:
+                    break
+        return out
+
+    def stats(self):
+        found = {}
+        for line in self.command("STATS"):
+            for name, pattern in self.STATS_PATTERNS.items():
+                m = re.search(pattern, line)
+                if m:
+                    found[name] = [float(g) if "." in g else int(g) for g in m.groups()]
+        return found
+
+
+def launch_native(path, socket_path):
+    proc = subprocess.Popen([path, socket_path], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, text=True, bufsize=1)
+
+    def write(text):
+        proc.stdin.write(text)
+        proc.stdin.flush()
+
+    console = Console(write, proc.stdout.readline)
+    deadline = time.monotonic() + 10
+    while not os.path.exists(socket_path):
+        if proc.poll() is not None or time.monotonic() > deadline:
+            raise RuntimeError("native build did not open %s" % socket_path)
+        time.sleep(0.05)
+    return proc, console
+
+
+def open_serial(port):
+    import serial
+    ser = serial.Serial(port, 115200, timeout=0.1)
+
+    def readline():
+        while True:
+            line = ser.readline()
+            if line:
+                return line.decode("utf-8", "replace")
+
+    return Console(lambda text: ser.write(text.encode()), readline)
+
+
+# ================================
+# LOAD RUN
+# ================================
+
+class LoadRunner:
+    def __init__(self, link, model, args):
+        self.link = link
+        self.model = model
+        self.args = args
+        self.pending = []
+        self.ring_messages = 0   # Everything sent that reaches the wing's receive ring
+        self.sent = 0            # Scenario messages
+        # Credits
+        self.credits = 0
+        self.offered = None
+        self.credit_request = 0  # Outstanding credit request number, 0 when none is
+        self.requested_at = None
+        self.credit_waits = 0
+        # Probes
+        self.pings = {}
+        self.ping_id = 0
+        self.pong_depth = None
+        self.ping_samples = []
+        self.depths = []
+        self.lost_pings = 0
+        self.encoder_probe = None
+        self.encoder_direction = 1
+        self.encoder_samples = []
+        self.lost_probes = 0
+        self.digests = {}
+
+    # ---- Receiving ----
+
+    def pump(self, timeout=0.0):
+        msg = self.link.receive(timeout)
+        while msg is not None:
+            self.dispatch(msg)
+            msg = self.link.receive(0)
+
+    def dispatch(self, msg):
+        kind, ch, d1, d2 = msg
+        if kind != 0xB0:
+            return
+        now = time.perf_counter()
+        if ch == LINK_CHANNEL:
+            if d1 == LINK_CC_CREDITS:
+                self.offered = d2
+            elif d1 == LINK_CC_GRANT and self.offered is not None:
+                # Only the answer to the outstanding request, never a keepalive (grant 0) or a late answer
+                if d2 != 0 and d2 == self.credit_request:
+                    self.credit_request = 0
+                    self.credits = self.offered
+                    self.requested_at = None
+            elif d1 == LINK_CC_PONG_DEPTH:
+                self.pong_depth = d2
+            elif d1 == LINK_CC_PONG and d2 in self.pings:
+                self.ping_samples.append((now - self.pings.pop(d2)) * 1e6)
+                if self.pong_depth is not None:
+                    self.depths.append(self.pong_depth)
+            elif LINK_CC_DIGEST <= d1 < LINK_CC_DIGEST + PAGE_DIGEST_GROUPS:
+                self.digests[d1 - LINK_CC_DIGEST] = d2
+            elif LINK_CC_DIGEST_HIGH <= d1 < LINK_CC_DIGEST_HIGH + PAGE_DIGEST_GROUPS:
+                self.digests[("high", d1 - LINK_CC_DIGEST_HIGH)] = d2
+            elif d1 == LINK_CC_DIGEST_NUMBER:
+                self.digests["number"] = d2
+        elif ch == 1 and d1 == PROBE_ENCODER + 1 and self.encoder_probe is not None:
+            self.encoder_samples.append((now - self.encoder_probe) * 1e6)
+            self.encoder_probe = None
+
+    # ---- Sending ----
+
+    def write(self, items):
+        """Sends `items` as one write, applying them to the model"""
+        data = bytearray()
+        for item in items:
+            if isinstance(item, Raw):
+                data += item.data
+                for m in item.messages:
+                    if m is not None:
+                        self.model.apply(*m)
+                self.ring_messages += len(item.messages)
+            else:
+                data += cc_bytes(*item)
+                self.model.apply(*item)
+                self.ring_messages += 1
+        if data:
+            self.link.send_bytes(data)
+
+    def link_cc(self, cc, value):
+        self.link.send_bytes(cc_bytes(LINK_CHANNEL, cc, value))
+        self.ring_messages += 1
+
+    def cost(self, item):
+        return len(item.messages) if isinstance(item, Raw) else 1
+
+    def flush(self):
+        """Sends what is pending, within the wing's receive credits unless --flood"""
+        while self.pending:
+            if self.args.flood:
+                self.sent += sum(self.cost(i) for i in self.pending)
+                self.write(self.pending)
+                self.pending = []
+                self.pump()
+                return
+
+            # One slot is kept for the next credit request, like the plugin
+            batch, used = [], 0
+            while self.pending and used + self.cost(self.pending[0]) < self.credits:
+                used += self.cost(self.pending[0])
+                batch.append(self.pending.pop(0))
+            if batch:
+                self.credits -= used
+                self.sent += used
+                self.write(batch)
+                continue
+
+            now = time.monotonic()
+            if self.requested_at is None or now - self.requested_at > 0.25:
+                if self.requested_at is not None:
+                    self.credit_waits += 1
+                self.credits = 0
+                self.credit_request = self.credit_request % 127 + 1
+                self.link_cc(LINK_CC_CREDITS, self.credit_request)
+                self.requested_at = now
+            self.pump(0.002)
+
+    # ---- Probes ----
+
+    def probe(self):
+        now = time.perf_counter()
+        for ping_id, start in list(self.pings.items()):
+            if now - start > 2.0:
+                del self.pings[ping_id]
+                self.lost_pings += 1
+        self.ping_id = self.ping_id % 127 + 1
+        self.pings[self.ping_id] = now
+        self.pong_depth = None
+        self.link_cc(LINK_CC_PING, self.ping_id)
+
+        if not self.link.can_inject:
+            return
+        if self.encoder_probe is not None:
+            if now - self.encoder_probe < 0.5:
+                return
+            self.lost_probes += 1
+        self.encoder_direction = -self.encoder_direction
+        self.encoder_probe = time.perf_counter()
+        self.link.encoder(PROBE_ENCODER, self.encoder_direction)
+
+    # ---- Run ----
+
+    def run(self, scenarios, duration):
+        start = time.monotonic()
+        end = start + duration
+        due = [start] * len(scenarios)
+        next_probe = start
+        generated = 0
+        while True:
+            now = time.monotonic()
+            if now >= end:
+                break
+            for i, scenario in enumerate(scenarios):
+                while due[i] <= now:
+                    items = scenario.tick(self.model)
+                    generated += sum(self.cost(item) for item in items)
+                    self.pending += items
+                    due[i] += scenario.interval
+            self.flush()
+            if now >= next_probe:
+                self.probe()
+                next_probe += PROBE_INTERVAL
+            self.pump(max(0.0, min(min(due), next_probe, end) - time.monotonic()))
+        self.flush()
+        elapsed = time.monotonic() - start
+        self.drain()
+        return generated, elapsed
+
+    def drain(self, quiet=0.3):
+        """Waits for the wing's ring to empty: a ping answered with depth 0, then quiet"""
+        deadline = time.monotonic() + 5.0
+        while time.monotonic() < deadline:
+            self.probe()
+            self.pump(0.05)
+            if self.depths and self.depths[-1] == 0 and not self.pings:
+                break
+        end = time.monotonic() + quiet
+        while time.monotonic() < end:
+            self.pump(0.01)
+
+    # ---- Checks ----
+
+    def prime(self, pages):
+        """Known state on every page the load touches: populated, a colour and a fader value per XKey"""
+        args = self.args
+        self.pending.append((3, 1, 1))
+        for page in range(1, pages + 1):
+            self.pending.append((3, 2, page))
+            for key in range(args.xkeys):
+                self.pending.append((2, key + 1, 65))
+                for c in range(3):
+                    self.pending.append((2, args.xkeys + 1 + key * 3 + c, (page * 13 + key * 7 + c * 40) % 128))
+                if key < args.encoders:
+                    self.pending.append((1, FADER_CC + key, (page * 5 + key * 11) % 128))
+            self.pending.append((3, 2, 0))
+        self.flush()  # Also waits out the firmware's startup
+        self.drain()
+        self.sent = 0
+        self.credit_waits = 0
+        self.pings, self.ping_samples, self.depths, self.lost_pings = {}, [], [], 0
+        self.encoder_probe, self.encoder_samples, self.lost_probes = None, [], 0
+
+    def verify(self):
+        """Page digests from the wing against the model, returns [(page, group, wing, expected)]"""
+        differ = []
+        number = 0
+        for page in sorted(self.model.touched):
+            self.write([(3, 1, page)])
+            number = number % 127 + 1
+            self.digests = {}
+            self.link_cc(LINK_CC_DIGEST_REQUEST, number)
+            deadline = time.monotonic() + 1.0
+            while self.digests.get("number") != number and time.monotonic() < deadline:
+                self.pump(0.01)
+            for group in range(PAGE_DIGEST_GROUPS):
+                expected = self.model.digest(page, group)
+                low, high = self.digests.get(group), self.digests.get(("high", group))
+                got = None if low is None or high is None else high << 7 | low
+                if got != expected:
+                    differ.append((page, group, got, expected))
+        self.write([(3, 1, 1)])
+        return differ
+
+
+def delta(before, after, name, index):
+    if name in before and name in after:
+        return after[name][index] - before[name][index]
+    return None
+
+
+def run_scenarios(link, console, names, args):
+    model = WingModel(args.xkeys, args.encoders)
+    runner = LoadRunner(link, model, args)
+    rng = random.Random(args.seed)
+    print("Priming pages 1-%d (%d XKeys, %d encoders)..." % (args.pages, args.xkeys, args.encoders))
+    runner.prime(args.pages)
+
+    scenarios = []
+    for name in names:
+        if name == "malformed":
+            scenarios.append(Malformed(args, rng, raw_ok=link.raw_ok))
+        else:
+            scenarios.append(SCENARIO_CLASSES[name](args, rng))
+
+    before = console.stats() if console else {}
+    ring_before = runner.ring_messages
+    generated, elapsed = runner.run(scenarios, args.duration)
+    after = console.stats() if console else {}
+    ring_sent = runner.ring_messages - ring_before
+
+    print()
+    print("=== %s: %.1fs, %s ===" % (" + ".join(names), args.duration,
+                                     "flood (no credits)" if args.flood else "credit paced"))
+    print("Messages: %d sent in %.2fs = %.0f msg/s (show asked for %.0f msg/s) | Credit waits over 250ms: %d" % (
+        runner.sent, elapsed, runner.sent / elapsed, generated / args.duration, runner.credit_waits))
+
+    frames = delta(before, after, "frames", 0)
+    if frames is not None:
+        busy = " | CPU busy: %.1f%%" % after["busy"][0] if "busy" in after else ""
+        print("LED frames: %d = %.1f fps | Forced (partial triplet): %d%s" % (
+            frames, frames / elapsed, delta(before, after, "frames", 1), busy))
+
+    if link.can_inject:
+        report("Encoder detent -> CC under load", runner.encoder_samples)
+        if runner.lost_probes:
+            print("Encoder probes without an answer: %d" % runner.lost_probes)
+    report("Link ping round trip under load", runner.ping_samples)
+    if runner.depths:
+        print("Wing ring depth at ping: max %d | Pings without an answer: %d" % (max(runner.depths), runner.lost_pings))
+
+    received = delta(before, after, "midi", 0)
+    if received is not None:
+        # Everything sent after the first STATS reached the ring by the second one, the wing is drained
+        dropped = ring_sent - received
+        line = "Wing received: %d of %d messages sent to its ring | Dropped: %d | Ring high water: %d" % (
+            received, ring_sent, dropped, after["midi"][2])
+        bridge_dropped = delta(before, after, "bridge", 1)
+        if bridge_dropped is not None:
+            line += " | Native bridge queue full: %d" % bridge_dropped
+        print(line)
+
+    differ = runner.verify()
+    groups = len(model.touched) * PAGE_DIGEST_GROUPS
+    print("Page digests: %d groups on %d pages, %d misapplied" % (groups, len(model.touched), len(differ)))
+    for page, group, got, expected in differ:
+        print("  page %d XKeys %d-%d: wing %s, expected %d" % (
+            page, group * model.group_keys + 1, min(args.xkeys, (group + 1) * model.group_keys), got, expected))
+    return not differ
+
+
+def main():
+    parser = argparse.ArgumentParser(description="EvoCmdWing synthetic show load generator")
+    parser.add_argument("scenarios", nargs="*", metavar="scenario",
+                        help="%s or mixed, run one after the other (default: each, then mixed)" % ", ".join(SCENARIOS))
+    parser.add_argument("--duration", type=float, default=5.0, help="seconds per scenario")
+    parser.add_argument("--flood", action="store_true", help="send without waiting for receive credits")
+    parser.add_argument("--xkeys", type=int, default=16)
+    parser.add_argument("--encoders", type=int, default=8, help="XKeys with an encoder (CC 6 up)")
+    parser.add_argument("--pages", type=int, default=8, help="pages scrolled through and checked")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--socket", default=DEFAULT_SOCKET)
+    parser.add_argument("--cable", type=int, default=CABLE_FEEDBACK, help="native build USB MIDI cable (0-3)")
+    parser.add_argument("--launch", metavar="PATH", help="start this native build on a temporary socket")
+    parser.add_argument("--midi-port", help="MIDI port of a real wing (mido) instead of the native socket")
+    parser.add_argument("--serial", metavar="PORT", help="wing serial port for STATS (pyserial)")
+    args = parser.parse_args()
+
+    names = args.scenarios or SCENARIOS + ["mixed"]
+    unknown = [n for n in names if n not in SCENARIOS + ["mixed"]]
+    if unknown:
+        parser.error("unknown scenario: %s" % ", ".join(unknown))
+    proc = None
+    console = None
+    try:
+        if args.launch:
+            args.socket = os.path.join(tempfile.mkdtemp(), "evocmdwing.sock")
+            proc, console = launch_native(args.launch, args.socket)
+        elif args.serial:
+            console = open_serial(args.serial)
+        link = MidoLink(args.midi_port) if args.midi_port else BridgeLink(args.socket, args.cable)
+    except (OSError, RuntimeError, ImportError) as e:
+        print("Could not connect: %s" % e)
+        if proc:
+            proc.terminate()
+        return 1
+
+    ok = True
+    try:
+        for name in names:
+            ok &= run_scenarios(link, console, SCENARIOS if name == "mixed" else [name], args)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        link.close()
+        if proc:
+            proc.terminate()
+            proc.wait()
+    return 0 if ok else 2
+
+
+if __name__ == "__main__":
+    sys.exit(main())